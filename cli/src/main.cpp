@@ -33,6 +33,7 @@
 #endif
 
 #if defined(HAVE_UNISTD_H)
+# include <cerrno>
 # include <unistd.h>
 #endif
 #if defined(HAVE_SYSEXITS_H)
@@ -51,6 +52,8 @@ static const char* script_filename = nullptr;
 static bool flag_test_syntax = false;
 static bool flag_fork = false;
 static std::string inline_script;
+static const char* image_filename = nullptr;
+static const char* save_image_filename = nullptr;
 #if PLORTH_ENABLE_FILE_SYSTEM_MODULES
 static std::unordered_set<std::u32string> imported_modules;
 #endif
@@ -59,7 +62,11 @@ static void scan_arguments(const std::shared_ptr<runtime>&, int, char**);
 static void compile_and_run(const std::shared_ptr<context>&,
                             const std::string&,
                             const std::u32string&);
+static void stream_and_run(const std::shared_ptr<context>&,
+                           const std::u32string&);
 static void handle_error(const std::shared_ptr<context>&);
+static void load_image(const std::shared_ptr<context>&, const char*);
+static void save_image(const std::shared_ptr<context>&, const char*);
 
 #if PLORTH_CLI_ENABLE_REPL
 static inline bool is_console_interactive();
@@ -85,6 +92,11 @@ int main(int argc, char** argv)
 
   scan_arguments(runtime, argc, argv);
 
+  if (image_filename)
+  {
+    load_image(context, image_filename);
+  }
+
 #if PLORTH_ENABLE_FILE_SYSTEM_MODULES
   for (const auto& module_path : imported_modules)
   {
@@ -108,7 +120,6 @@ int main(int argc, char** argv)
       );
 
       is.close();
-      context->clear();
 #if PLORTH_ENABLE_FILE_SYSTEM_MODULES
       context->filename(decoded_script_filename);
 #endif
@@ -125,6 +136,10 @@ int main(int argc, char** argv)
   else if (!inline_script.empty())
   {
     compile_and_run(context, inline_script, U"-e");
+  }
+  else if (save_image_filename)
+  {
+    // Nothing to execute; just store the imported modules into the image.
 #if PLORTH_CLI_ENABLE_REPL
   }
   else if (is_console_interactive())
@@ -132,14 +147,22 @@ int main(int argc, char** argv)
     plorth::cli::repl_loop(context);
 #endif
   } else {
-    compile_and_run(
-      context,
-      std::string(
-        std::istreambuf_iterator<char>(std::cin),
-        std::istreambuf_iterator<char>()
-      ),
-      U"<stdin>"
-    );
+    stream_and_run(context, U"<stdin>");
+  }
+
+#if PLORTH_ENABLE_GREEN_THREADS
+  // Run the tasks started by the script until they have been completed.
+  scheduler::current().join();
+#endif
+
+#if PLORTH_ENABLE_THREADS
+  // Wait for the actors spawned by the script to finish their work.
+  runtime->actors().join();
+#endif
+
+  if (save_image_filename)
+  {
+    save_image(context, save_image_filename);
   }
 
   return EXIT_SUCCESS;
@@ -163,6 +186,14 @@ static void print_usage(std::ostream& out, const char* executable)
 #if PLORTH_ENABLE_FILE_SYSTEM_MODULES
   out << "  -r <path>    Import module before executing script." << std::endl;
 #endif
+  out << "  --image <file>" << std::endl
+      << "               Restore words and data stack from an image before "
+      << "executing script."
+      << std::endl;
+  out << "  --save-image <file>" << std::endl
+      << "               Store words and data stack into an image after "
+      << "executing script."
+      << std::endl;
   out << "  --version    Print the version." << std::endl;
   out << "  --help       Display this message." << std::endl;
   out << std::endl;
@@ -206,6 +237,24 @@ static void scan_arguments(const std::shared_ptr<class runtime>& runtime,
         std::cerr << "Plorth " << utf8_encode(PLORTH_VERSION) << std::endl;
         std::exit(EXIT_SUCCESS);
       }
+      else if (!std::strcmp(arg, "--image")
+               || !std::strcmp(arg, "--save-image"))
+      {
+        if (offset >= argc)
+        {
+          std::cerr << "Argument expected for the " << arg << " option."
+                    << std::endl;
+          print_usage(std::cerr, argv[0]);
+          std::exit(EX_USAGE);
+        }
+        if (arg[2] == 'i')
+        {
+          image_filename = argv[offset++];
+        } else {
+          save_image_filename = argv[offset++];
+        }
+        continue;
+      }
       else if (!std::strcmp(arg, "--"))
       {
         if (offset < argc)
@@ -319,20 +368,25 @@ static void handle_error(const std::shared_ptr<context>& ctx)
   std::exit(EXIT_FAILURE);
 }
 
+static void fork_to_background()
+{
+#if HAVE_FORK
+  if (fork())
+  {
+    std::exit(EXIT_SUCCESS);
+  }
+#else
+  std::cerr << "Forking to background is not supported on this platform." << std::endl;
+#endif
+}
+
 static void compile_and_run(const std::shared_ptr<context>& ctx,
                             const std::string& input,
                             const std::u32string& filename)
 {
-  std::u32string source;
   std::shared_ptr<quote> script;
 
-  if (!utf8_decode_test(input, source))
-  {
-    std::cerr << "Import error: Unable to decode source code as UTF-8." << std::endl;
-    std::exit(EXIT_FAILURE);
-  }
-
-  if (!(script = ctx->compile(source, filename)))
+  if (!(script = ctx->compile(input.c_str(), input.length(), filename)))
   {
     handle_error(ctx);
     return;
@@ -347,18 +401,129 @@ static void compile_and_run(const std::shared_ptr<context>& ctx,
 
   if (flag_fork)
   {
-#if HAVE_FORK
-    if (fork())
+    fork_to_background();
+  }
+
+  if (!script->call(ctx))
+  {
+    handle_error(ctx);
+  }
+}
+
+/**
+ * Compiles and executes source code read from standard input in chunks, so
+ * that the program can start running before all of it has been received.
+ */
+static void stream_and_run(const std::shared_ptr<context>& ctx,
+                           const std::u32string& filename)
+{
+  incremental_compiler compiler(filename);
+  std::shared_ptr<quote> script;
+  char buffer[4096];
+  bool forked = !flag_fork;
+  bool compiled;
+
+  for (;;)
+  {
+#if defined(HAVE_UNISTD_H)
+    // Unlike std::istream::read(), read() returns whatever input is
+    // currently available instead of waiting for the buffer to fill up.
+    const auto length = ::read(STDIN_FILENO, buffer, sizeof(buffer));
+
+    if (length < 0 && errno == EINTR)
     {
-      std::exit(EXIT_SUCCESS);
+      continue;
     }
 #else
-    std::cerr << "Forking to background is not supported on this platform." << std::endl;
+    std::cin.read(buffer, sizeof(buffer));
+    const auto length = std::cin.gcount();
 #endif
+
+    if (length > 0)
+    {
+      compiled = compiler.feed(ctx, buffer, length, script);
+    } else {
+      compiled = compiler.finish(ctx, script);
+    }
+    if (!compiled)
+    {
+      handle_error(ctx);
+    }
+    if (script && !flag_test_syntax)
+    {
+      if (!forked)
+      {
+        fork_to_background();
+        forked = true;
+      }
+      if (!script->call(ctx))
+      {
+        handle_error(ctx);
+      }
+    }
+    if (length <= 0)
+    {
+      break;
+    }
   }
 
-  if (!script->call(ctx))
+  if (flag_test_syntax)
+  {
+    std::cerr << "Syntax OK." << std::endl;
+    std::exit(EXIT_SUCCESS);
+  }
+}
+
+static void load_image(const std::shared_ptr<context>& ctx,
+                       const char* filename)
+{
+  std::ifstream is(filename, std::ios_base::in | std::ios_base::binary);
+  std::string image;
+
+  if (!is.good())
+  {
+    std::cerr << "Unable to open image `"
+              << filename
+              << "' for reading."
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  image = std::string(
+    std::istreambuf_iterator<char>(is),
+    std::istreambuf_iterator<char>()
+  );
+  is.close();
+
+  if (!ctx->runtime()->load_image(ctx, image.c_str(), image.length()))
   {
     handle_error(ctx);
   }
 }
+
+static void save_image(const std::shared_ptr<context>& ctx,
+                       const char* filename)
+{
+  std::string image;
+  std::ofstream os;
+
+  if (!ctx->runtime()->save_image(ctx, image))
+  {
+    handle_error(ctx);
+  }
+
+  os.open(
+    filename,
+    std::ios_base::out | std::ios_base::binary | std::ios_base::trunc
+  );
+  if (!os.good())
+  {
+    std::cerr << "Unable to open image `"
+              << filename
+              << "' for writing."
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  os.write(image.c_str(), image.length());
+  os.close();
+}
@@ -27,9 +27,8 @@
 #if PLORTH_CLI_ENABLE_REPL
 # include <cstring>
 
-# include <plorth/context.hpp>
+# include <plorth/compiler.hpp>
 # include <plorth/cli/terminal.hpp>
-# include "./utils.hpp"
 
 namespace plorth
 {
@@ -40,8 +39,8 @@ namespace plorth
     void repl_loop(const std::shared_ptr<context>& ctx)
     {
       int line_counter = 0;
-      std::u32string source;
-      std::stack<char32_t> open_braces;
+      incremental_compiler compiler(U"<repl>");
+      std::shared_ptr<quote> script;
       char prompt[BUFSIZ];
 
       initialize_repl_api(ctx->runtime());
@@ -52,15 +51,15 @@ namespace plorth
 
         // First construct the prompt which is shown to the user. It contains
         // text "plorth", current line number, size of the execution context
-        // and visual indication on whether the source code still contains open
-        // braces or not.
+        // and visual indication on whether the source code still contains
+        // incomplete values or not.
         std::snprintf(
           prompt,
           BUFSIZ,
           "plorth:%d:%ld%c ",
           ++line_counter,
           ctx->size(),
-          open_braces.empty() ? '>' : '*'
+          compiler.pending() ? '*' : '>'
         );
 
         // Read line from the user.
@@ -69,42 +68,36 @@ namespace plorth
           break;
         }
 
-        // Skip empty lines.
-        if (line.empty())
+        // Add non-empty lines into history.
+        if (!line.empty())
         {
-          continue;
+          terminal::add_to_history(line);
         }
 
-        // Add the line into history.
-        terminal::add_to_history(line);
-
-        source.append(line);
-
         // Insert new line into the source code so that the line counter is
         // properly increased.
-        source.append(1, '\n');
-
-        // See whether the line contains special characters such as open braces
-        // and so on.
-        utils::count_open_braces(line, line.length(), open_braces);
+        line.append(1, '\n');
 
-        // Do not attempt to compile the source code when it still has unclosed
-        // braces.
-        if (!open_braces.empty())
+        // Feed the line into the compiler, which compiles values completed by
+        // the line and retains incomplete ones until rest of them is
+        // received. Completed values are executed unless syntax errors were
+        // encountered. Temporary values created during the evaluation are
+        // allocated from an allocation region.
         {
-          continue;
-        }
-
-        // Attempt to compile the source code into a quote and execute it
-        // unless syntax errors were encountered.
-        if (auto script = ctx->compile(source, U"<repl>", line_counter))
-        {
-          script->call(ctx);
+          const auto encoded_line = utf8_encode(line);
+          memory::region region(ctx->runtime()->memory_manager());
+
+          if (compiler.feed(ctx,
+                            encoded_line.c_str(),
+                            encoded_line.length(),
+                            script)
+              && script)
+          {
+            script->call(ctx);
+          }
+          script.reset();
         }
 
-        // Clear the source code buffer so that we can use it again.
-        source.clear();
-
         // If the execution context has any error present, display it. Also
         // reset the error status so that the execution context can be reused.
         if (const auto& error = ctx->error())
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2017-2018, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PLORTH_ACTOR_SYSTEM_HPP_GUARD
+#define PLORTH_ACTOR_SYSTEM_HPP_GUARD
+
+#include <plorth/value-number.hpp>
+
+#if PLORTH_ENABLE_THREADS
+# include <condition_variable>
+# include <deque>
+# include <mutex>
+# include <thread>
+# include <unordered_map>
+# include <vector>
+#endif
+
+namespace plorth
+{
+  class context;
+  class quote;
+
+#if PLORTH_ENABLE_THREADS
+  /**
+   * Actor system runs quotes concurrently in execution contexts of their
+   * own, each of them on a dedicated thread. Actors communicate with each
+   * other by sending messages into mailboxes of each other. Since values are
+   * immutable, messages are shared between the actors without copying them.
+   *
+   * Actors are identified by integer numbers. Contexts which have not been
+   * spawned as actors, such as the main context of the interpreter, are
+   * assigned an identifier and a mailbox once they need one.
+   */
+  class actor_system
+  {
+  public:
+    using id_type = number::int_type;
+
+    explicit actor_system(class runtime* runtime);
+
+    /**
+     * Destructor. Waits for all actors to terminate.
+     */
+    ~actor_system();
+
+    /**
+     * Starts executing given quote in new execution context, which is run
+     * by a thread of it's own. Words from the local dictionary of the
+     * calling context are copied into the new context.
+     *
+     * \param ctx   Calling execution context.
+     * \param quote Quote to execute as an actor.
+     * \return      Identifier of the new actor.
+     */
+    id_type spawn(const std::shared_ptr<context>& ctx,
+                  const std::shared_ptr<class quote>& quote);
+
+    /**
+     * Places given value into mailbox of an actor. Messages sent to actors
+     * which have already terminated are discarded.
+     *
+     * \param ctx     Calling execution context, used for error reporting.
+     * \param id      Identifier of the receiving actor.
+     * \param message Value to send.
+     * \return        Boolean flag telling whether the actor identifier was
+     *                valid or not.
+     */
+    bool send(const std::shared_ptr<context>& ctx,
+              id_type id,
+              const std::shared_ptr<value>& message);
+
+    /**
+     * Removes the oldest message from the mailbox of given execution context
+     * and returns it. If the mailbox is empty, waits until a message
+     * arrives.
+     *
+     * \param ctx  Receiving execution context, also used for error
+     *             reporting.
+     * \param slot Where the received message will be placed into.
+     * \return     Boolean flag telling whether a message was received, or
+     *             whether no message can ever arrive.
+     */
+    bool receive(const std::shared_ptr<context>& ctx,
+                 std::shared_ptr<value>& slot);
+
+    /**
+     * Returns the actor identifier of given execution context, assigning
+     * one for it if it doesn't have one yet.
+     */
+    id_type self(const std::shared_ptr<context>& ctx);
+
+    /**
+     * Waits until all actors have terminated. If all remaining actors are
+     * waiting for messages which can never arrive, their mailboxes are
+     * closed, which causes them to terminate with an error.
+     */
+    void join();
+
+    actor_system(const actor_system&) = delete;
+    actor_system(actor_system&&) = delete;
+    void operator=(const actor_system&) = delete;
+    void operator=(actor_system&&) = delete;
+
+  private:
+    struct mailbox
+    {
+      /** Messages waiting to be received. */
+      std::deque<std::shared_ptr<value>> messages;
+      /** Signaled when a message arrives or mailbox is closed. */
+      std::condition_variable available;
+      /** Whether the owner of the mailbox is not an actor. */
+      bool external = false;
+      /** Whether the actor is waiting for messages to arrive. */
+      bool waiting = false;
+    };
+
+    static void run(actor_system* system,
+                    id_type id,
+                    std::shared_ptr<context> ctx,
+                    std::shared_ptr<class quote> quote);
+    void execute(id_type id,
+                 std::shared_ptr<context> ctx,
+                 std::shared_ptr<class quote> quote);
+    void reap(std::unique_lock<std::mutex>& lock,
+              std::vector<std::thread>& threads);
+    void notify_changed();
+
+  private:
+    /** Runtime which owns the actor system. */
+    class runtime* m_runtime;
+    /** Protects all of the state of the actor system. */
+    std::mutex m_mutex;
+    /** Signaled when an actor terminates or begins to wait for messages. */
+    std::condition_variable m_changed;
+    /** Mailboxes of actors and other contexts, indexed by identifier. */
+    std::unordered_map<id_type, std::shared_ptr<mailbox>> m_mailboxes;
+    /** Mailboxes of contexts which are not actors. */
+    std::vector<std::shared_ptr<mailbox>> m_external;
+    /** Threads of the actors which have not been joined yet. */
+    std::unordered_map<id_type, std::thread> m_threads;
+    /** Identifiers of terminated actors whose threads can be joined. */
+    std::vector<id_type> m_terminated;
+    /** Identifier given to the next actor or context. */
+    id_type m_next_id;
+    /** Number of actors currently running. */
+    std::size_t m_live;
+    /** Number of actors currently waiting for messages. */
+    std::size_t m_waiting;
+    /** Whether the mailboxes have been closed. */
+    bool m_closed;
+  };
+#endif
+}
+
+#endif /* !PLORTH_ACTOR_SYSTEM_HPP_GUARD */
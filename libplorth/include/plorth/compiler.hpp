@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2017-2018, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PLORTH_COMPILER_HPP_GUARD
+#define PLORTH_COMPILER_HPP_GUARD
+
+#include <plorth/context.hpp>
+
+namespace plorth
+{
+  /**
+   * Resumable compiler which consumes UTF-8 encoded source code in chunks,
+   * such as lines typed into a REPL or blocks read from a stream. Top level
+   * values are compiled as soon as they have been completed, while source
+   * code of incomplete values is retained until rest of it arrives.
+   *
+   * Scanning state (nesting of quotes, arrays, objects and words, string
+   * literals and comments) is kept across the chunks, so each byte of the
+   * source code is scanned only once and compiled only once.
+   */
+  class incremental_compiler
+  {
+  public:
+    /**
+     * Constructs new incremental compiler.
+     *
+     * \param filename Optional file name information from which the source
+     *                 code is read from.
+     * \param line     Initial line number of the source code.
+     * \param column   Initial column number of the source code.
+     */
+    explicit incremental_compiler(const std::u32string& filename = U"",
+                                  int line = 1,
+                                  int column = 1);
+
+    /**
+     * Returns true if the compiler has received source code of a top level
+     * value which has not been completed yet, i.e. it still has unclosed
+     * quotes, arrays, objects, words or string literals.
+     */
+    bool pending() const;
+
+    /**
+     * Feeds chunk of source code into the compiler and compiles all top
+     * level values that were completed by it.
+     *
+     * \param ctx    Execution context where syntax errors are reported to.
+     * \param chunk  Pointer to the UTF-8 encoded source code.
+     * \param length Length of the chunk in bytes.
+     * \param slot   Where quote containing the completed values is stored
+     *               into, or null reference if no values were completed.
+     * \return       Boolean flag telling whether the compilation was
+     *               successful or not. Source code fed into the compiler
+     *               before a syntax error is discarded.
+     */
+    bool feed(const std::shared_ptr<context>& ctx,
+              const char* chunk,
+              std::size_t length,
+              std::shared_ptr<quote>& slot);
+
+    /**
+     * Signals end of input and compiles all the remaining source code. Any
+     * value still left incomplete results in a syntax error.
+     *
+     * \param ctx  Execution context where syntax errors are reported to.
+     * \param slot Where quote containing the remaining values is stored
+     *             into.
+     * \return     Boolean flag telling whether the compilation was
+     *             successful or not.
+     */
+    bool finish(const std::shared_ptr<context>& ctx,
+                std::shared_ptr<quote>& slot);
+
+    /**
+     * Discards source code of incomplete values. Line and column numbers
+     * continue from where they were.
+     */
+    void reset();
+
+    incremental_compiler(const incremental_compiler&) = delete;
+    incremental_compiler(incremental_compiler&&) = delete;
+    void operator=(const incremental_compiler&) = delete;
+    void operator=(incremental_compiler&&) = delete;
+
+  private:
+    /**
+     * Enumeration of different scanner states which can span across chunks.
+     */
+    enum class state
+    {
+      /** Between values. */
+      none,
+      /** Inside a symbol. */
+      symbol,
+      /** Inside a string literal. */
+      string,
+      /** After backslash inside a string literal. */
+      escape,
+      /** Inside a line comment. */
+      comment
+    };
+
+    void scan();
+    bool compile(const std::shared_ptr<context>& ctx,
+                 std::size_t length,
+                 std::shared_ptr<quote>& slot);
+
+  private:
+    /** File name given to the compiled source code. */
+    const std::u32string m_filename;
+    /** Source code which has not been compiled yet. */
+    std::string m_buffer;
+    /** Number of bytes in the buffer which have already been scanned. */
+    std::size_t m_scanned;
+    /** End of the last completed top level value in the buffer. */
+    std::size_t m_boundary;
+    /** Line and column number of the beginning of the buffer. */
+    int m_line;
+    int m_column;
+    /** Line and column number of the end of the last completed value. */
+    int m_boundary_line;
+    int m_boundary_column;
+    /** Line and column number of the scanner. */
+    int m_scan_line;
+    int m_scan_column;
+    /** Current state of the scanner. */
+    enum state m_state;
+    /** Separator of the string literal being scanned. */
+    char m_separator;
+    /**
+     * Characters closing the currently open quotes, arrays, objects and
+     * words, innermost last.
+     */
+    std::vector<char> m_frames;
+  };
+}
+
+#endif /* !PLORTH_COMPILER_HPP_GUARD */
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2017-2018, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PLORTH_CONTEXT_POOL_HPP_GUARD
+#define PLORTH_CONTEXT_POOL_HPP_GUARD
+
+#include <plorth/context.hpp>
+
+namespace plorth
+{
+  /**
+   * Pool of reusable execution contexts, intended for embedding scenarios
+   * where each request is executed in a fresh context. Instead of
+   * constructing new context for each request, contexts are acquired from
+   * the pool and released back into it once the request has been processed,
+   * which resets them back into their initial state.
+   *
+   * Local dictionaries of the contexts are layered on top of a shared
+   * template dictionary, so words defined into the template are available
+   * in each context without having to copy them.
+   *
+   * The pool itself performs no locking; it must not be accessed by multiple
+   * threads simultaneously.
+   */
+  class context_pool
+  {
+  public:
+    using size_type = std::size_t;
+
+    /** Default maximum number of idle contexts retained by the pool. */
+    static const size_type default_max_size;
+
+    /**
+     * Constructs new context pool.
+     *
+     * \param runtime             Runtime used by the contexts.
+     * \param dictionary_template Words which are available to each context
+     *                            acquired from the pool.
+     * \param max_size            Maximum number of idle contexts retained by
+     *                            the pool. Contexts released into a full
+     *                            pool are simply discarded.
+     */
+    explicit context_pool(
+      const std::shared_ptr<class runtime>& runtime,
+      const class dictionary& dictionary_template = plorth::dictionary(),
+      size_type max_size = default_max_size
+    );
+
+    /**
+     * Returns the runtime used by the contexts.
+     */
+    inline const std::shared_ptr<class runtime>& runtime() const
+    {
+      return m_runtime;
+    }
+
+    /**
+     * Returns the template dictionary shared by the contexts.
+     */
+    inline const std::shared_ptr<const class dictionary>& dictionary() const
+    {
+      return m_dictionary_template;
+    }
+
+    /**
+     * Returns the number of idle contexts currently retained by the pool.
+     */
+    inline size_type size() const
+    {
+      return m_contexts.size();
+    }
+
+    /**
+     * Returns an idle context from the pool, or constructs new one if the
+     * pool is empty.
+     */
+    std::shared_ptr<context> acquire();
+
+    /**
+     * Resets given context and returns it back into the pool. Context given
+     * as argument must have been acquired from this pool and it must not be
+     * used by the caller anymore after it has been released.
+     */
+    void release(const std::shared_ptr<context>& ctx);
+
+    /**
+     * Constructs idle contexts into the pool until it contains given number
+     * of contexts, or maximum size of the pool has been reached.
+     */
+    void reserve(size_type size);
+
+    context_pool(const context_pool&) = delete;
+    context_pool(context_pool&&) = delete;
+    void operator=(const context_pool&) = delete;
+    void operator=(context_pool&&) = delete;
+
+  private:
+    /** Runtime used by the contexts. */
+    const std::shared_ptr<class runtime> m_runtime;
+    /** Template dictionary shared by the contexts. */
+    const std::shared_ptr<const class dictionary> m_dictionary_template;
+    /** Maximum number of idle contexts retained by the pool. */
+    const size_type m_max_size;
+    /** Idle contexts. */
+    std::vector<std::shared_ptr<context>> m_contexts;
+  };
+}
+
+#endif /* !PLORTH_CONTEXT_POOL_HPP_GUARD */
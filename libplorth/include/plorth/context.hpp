@@ -30,6 +30,7 @@
 #include <plorth/value-error.hpp>
 
 #include <deque>
+#include <vector>
 
 namespace plorth
 {
@@ -43,6 +44,47 @@ namespace plorth
   public:
     using container_type = std::deque<std::shared_ptr<value>>;
 
+    /**
+     * Frame in the return stack of the context, i.e. compiled quote which is
+     * currently being executed and offset of the next instruction in it.
+     */
+    struct frame
+    {
+      /** Quote being executed. */
+      const class quote* quote;
+      /**
+       * Reference to the quote being executed, unless the quote is being
+       * kept alive by the caller.
+       */
+      std::shared_ptr<class quote> reference;
+      /** Offset of the next instruction to execute. */
+      std::size_t offset;
+    };
+    using frame_container = std::vector<frame>;
+
+#if PLORTH_ENABLE_INLINE_CACHE
+    /**
+     * Cached result of resolving a symbol. The result can be reused as long
+     * as the topmost value of the data stack has the same prototype and
+     * neither the local nor the global dictionary has been modified since.
+     */
+    struct inline_cache_entry
+    {
+      /** Symbol which was resolved. */
+      std::shared_ptr<class symbol> symbol;
+      /** Prototype of the topmost value of the stack during the lookup. */
+      std::shared_ptr<class object> prototype;
+      /** Generation of the local dictionary during the lookup. */
+      std::uint64_t local_generation;
+      /** Generation of the global dictionary during the lookup. */
+      std::uint64_t global_generation;
+      /** Quote which the symbol resolved into, if any. */
+      std::shared_ptr<class quote> callee;
+      /** Otherwise value which the symbol resolved into. */
+      std::shared_ptr<class value> value;
+    };
+#endif
+
     /**
      * Constructs new context.
      *
@@ -53,6 +95,23 @@ namespace plorth
       const std::shared_ptr<class runtime>& runtime
     );
 
+    /**
+     * Constructs new context which local dictionary is layered on top of
+     * given template dictionary. Words from the template dictionary are
+     * visible to the context without having to copy them, and resetting the
+     * context returns it's local dictionary back to the template.
+     *
+     * \param runtime             Runtime associated with this context.
+     * \param dictionary_template Dictionary used as template for the local
+     *                            dictionary of the context. Must not be
+     *                            modified while the context exists.
+     * \return                    Reference to the created context.
+     */
+    static std::shared_ptr<context> make(
+      const std::shared_ptr<class runtime>& runtime,
+      const std::shared_ptr<const class dictionary>& dictionary_template
+    );
+
     /**
      * Returns the runtime associated with this context.
      */
@@ -101,6 +160,19 @@ namespace plorth
       m_error.reset();
     }
 
+    /**
+     * Returns the context into the state it was in when it was constructed,
+     * so that it can be reused for executing another script. Data stack,
+     * uncaught error, return stack and position information are cleared and
+     * words defined into the local dictionary are removed, leaving only the
+     * words from the template dictionary, if the context has one. Memory
+     * reserved for the return stack and the inline cache is retained, while
+     * the data stack may release the memory it has allocated. The inline
+     * cache is invalidated without going through it's entries, so values
+     * referenced by it are released only once the entries are reused.
+     */
+    void reset();
+
     /**
      * Returns the dictionary used by this context to store words.
      */
@@ -135,6 +207,27 @@ namespace plorth
                                    int line = 1,
                                    int column = 1);
 
+    /**
+     * Compiles given UTF-8 encoded source code into a quote. The source code
+     * is compiled directly from the encoded bytes, without decoding it first.
+     *
+     * \param source   Pointer to the UTF-8 encoded source code.
+     * \param length   Length of the source code in bytes.
+     * \param filename Optional file name information from which the source
+     *                 code was read from.
+     * \param line     Initial line number of the source code. This is for
+     *                 debugging purposes only.
+     * \param column   Initial column number of the source code. This is for
+     *                 debugging purposes only.
+     * \return         Reference the quote that was compiled from given source,
+     *                 or null reference if syntax error was encountered.
+     */
+    std::shared_ptr<quote> compile(const char* source,
+                                   std::size_t length,
+                                   const std::u32string& filename = U"",
+                                   int line = 1,
+                                   int column = 1);
+
     /**
      * Provides direct access to the data stack.
      */
@@ -183,6 +276,14 @@ namespace plorth
       m_data.push_back(value);
     }
 
+    /**
+     * Moves given value into the data stack.
+     */
+    inline void push(std::shared_ptr<class value>&& value)
+    {
+      m_data.push_back(std::move(value));
+    }
+
     /**
      * Pushes null value into the data stack.
      */
@@ -387,6 +488,17 @@ namespace plorth
      */
     bool pop_word(std::shared_ptr<word>& slot);
 
+    /**
+     * Pops sequence from the data stack and places it into given slot. If
+     * the stack is empty, range error will be set. If something else than
+     * sequence is as top-most value of the stack, type error will be set.
+     *
+     * \param slot Where the sequence will be placed into.
+     * \return     Boolean flag that tells whether the operation was
+     *             successfull or not.
+     */
+    bool pop_sequence(std::shared_ptr<sequence>& slot);
+
 #if PLORTH_ENABLE_FILE_SYSTEM_MODULES
     /**
      * Returns optional filename of the context, when the context is executed
@@ -407,6 +519,25 @@ namespace plorth
     }
 #endif
 
+#if PLORTH_ENABLE_THREADS
+    /**
+     * Returns identifier of the context in the actor system of the runtime,
+     * or zero if the context hasn't been assigned one yet.
+     */
+    inline actor_system::id_type actor_id() const
+    {
+      return m_actor_id;
+    }
+
+    /**
+     * Sets identifier of the context in the actor system of the runtime.
+     */
+    inline void actor_id(actor_system::id_type id)
+    {
+      m_actor_id = id;
+    }
+#endif
+
     /**
      * Returns reference to a structure which has information about current
      * position in source code.
@@ -425,17 +556,95 @@ namespace plorth
       return m_position;
     }
 
+    /**
+     * Returns the return stack of the context, which contains the compiled
+     * quotes currently being executed.
+     */
+    inline frame_container& frames()
+    {
+      return m_frames;
+    }
+
+    /**
+     * Returns the return stack of the context, which contains the compiled
+     * quotes currently being executed.
+     */
+    inline const frame_container& frames() const
+    {
+      return m_frames;
+    }
+
+    /**
+     * Returns the number of nested calls currently being executed by native
+     * C++ code, i.e. calls which consume the native C++ stack.
+     */
+    inline unsigned int depth() const
+    {
+      return m_depth;
+    }
+
+    /**
+     * Increments or decrements the number of nested calls being executed by
+     * native C++ code.
+     */
+    inline unsigned int& depth()
+    {
+      return m_depth;
+    }
+
+#if PLORTH_ENABLE_INLINE_CACHE
+    /**
+     * Returns inline cache entry which given symbol maps into. The entry may
+     * contain result of resolving some other symbol, so the symbol stored in
+     * the entry has to be compared before using it.
+     */
+    inline_cache_entry& inline_cache(const class symbol* symbol);
+#endif
+
+    /**
+     * Requests given quote to be called once the native word currently being
+     * executed has returned. This allows words such as `if-else' to call
+     * quotes without nesting calls in the native C++ stack, which makes tail
+     * calls through them possible. The native word must not do anything else
+     * after requesting the call.
+     *
+     * \param quote Quote to call.
+     */
+    inline void tail_call(const std::shared_ptr<class quote>& quote)
+    {
+      m_tail_call = quote;
+    }
+
+    /**
+     * Removes and returns quote which has been requested to be called with
+     * the tail_call() method, or null reference if there is no such quote.
+     */
+    inline std::shared_ptr<class quote> take_tail_call()
+    {
+      std::shared_ptr<class quote> quote;
+
+      quote.swap(m_tail_call);
+
+      return quote;
+    }
+
   protected:
     /**
      * Constructs new context.
      *
      * \param runtime Runtime associated with this context.
      */
-    explicit context(const std::shared_ptr<class runtime>& runtime);
+    explicit context(
+      const std::shared_ptr<class runtime>& runtime,
+      const std::shared_ptr<const class dictionary>& dictionary_template
+        = std::shared_ptr<const class dictionary>()
+    );
 
   private:
     /** Runtime associated with this context. */
     const std::shared_ptr<class runtime> m_runtime;
+    /** Optional template for the local dictionary. */
+    const std::shared_ptr<const class dictionary> m_dictionary_template;
     /** Currently uncaught error in this context. */
     std::shared_ptr<class error> m_error;
     /** Data stack used for storing values in this context. */
@@ -448,6 +657,20 @@ namespace plorth
 #endif
     /** Current position in source code. */
     struct position m_position;
+    /** Return stack of compiled quotes currently being executed. */
+    frame_container m_frames;
+    /** Number of nested calls being executed by native C++ code. */
+    unsigned int m_depth;
+    /** Quote requested to be called after current native word returns. */
+    std::shared_ptr<class quote> m_tail_call;
+#if PLORTH_ENABLE_INLINE_CACHE
+    /** Cached results of resolving symbols, allocated on first use. */
+    std::unique_ptr<inline_cache_entry[]> m_inline_cache;
+#endif
+#if PLORTH_ENABLE_THREADS
+    /** Identifier of the context in the actor system. */
+    actor_system::id_type m_actor_id;
+#endif
   };
 }
 
@@ -28,7 +28,9 @@
 
 #include <plorth/value-word.hpp>
 
+#include <cstdint>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace plorth
@@ -36,6 +38,12 @@ namespace plorth
   /**
    * Dictionary is a collection of words, containing one quote for each
    * individual symbol.
+   *
+   * Dictionary can be layered on top of another dictionary, in which case
+   * words not found from the dictionary itself are looked up from the parent
+   * dictionary. Insertions always go into the dictionary itself, leaving the
+   * parent dictionary untouched, so single parent dictionary can be shared
+   * between multiple dictionaries.
    */
   class dictionary
   {
@@ -50,6 +58,13 @@ namespace plorth
      */
     dictionary();
 
+    /**
+     * Constructs new empty dictionary layered on top of given parent
+     * dictionary. The parent dictionary must outlive this one, and it must
+     * not be modified while it's being shared.
+     */
+    explicit dictionary(const dictionary* parent);
+
     /**
      * Constructs copy of existing dictionary.
      */
@@ -61,11 +76,18 @@ namespace plorth
     dictionary& operator=(const dictionary& that);
 
     /**
-     * Returns the number of words the dictionary contains.
+     * Returns the number of words the dictionary contains, including words
+     * inherited from the parent dictionary.
+     */
+    size_type size() const;
+
+    /**
+     * Returns the parent dictionary or null pointer if this dictionary has
+     * no parent.
      */
-    inline size_type size() const
+    inline const dictionary* parent() const
     {
-      return m_words.size();
+      return m_parent;
     }
 
     /**
@@ -93,9 +115,64 @@ namespace plorth
      */
     void insert(const value_type& word);
 
+    /**
+     * Removes all words from the dictionary, except the ones inherited from
+     * the parent dictionary.
+     */
+    void clear();
+
+    /**
+     * Returns true if the dictionary contains words which override built-in
+     * words that the compiler is allowed to replace with superinstructions,
+     * in which case such optimizations must not be used.
+     */
+    inline bool shadows_builtins() const
+    {
+      return m_shadows_builtins || (m_parent && m_parent->shadows_builtins());
+    }
+
+    /**
+     * Declares words currently contained in the dictionary as the built-in
+     * ones, i.e. they do not count as overrides of built-in words.
+     */
+    void mark_builtins();
+
+    /**
+     * Returns true if given word has been declared as built-in word with the
+     * mark_builtins() method.
+     */
+    inline bool is_builtin(const value_type& word) const
+    {
+      return m_builtins.find(word) != std::end(m_builtins)
+        || (m_parent && m_parent->is_builtin(word));
+    }
+
+    /**
+     * Returns generation of the dictionary, which changes whenever contents
+     * of the dictionary are modified. Generations are unique across all
+     * dictionaries, so results of word lookups can be cached as long as the
+     * generation stays the same.
+     */
+    inline std::uint64_t generation() const
+    {
+      return m_generation;
+    }
+
   private:
+    /** Optional parent dictionary. */
+    const dictionary* m_parent;
     /** Container for the words in the dictionary. */
     container_type m_words;
+    /**
+     * Words which have been declared as built-in ones. References to them
+     * are being held so that their addresses cannot be reused by other words
+     * after they have been overridden.
+     */
+    std::unordered_set<value_type> m_builtins;
+    /** Whether the dictionary overrides built-in words. */
+    bool m_shadows_builtins;
+    /** Current generation of the dictionary. */
+    std::uint64_t m_generation;
   };
 }
 
@@ -61,6 +61,17 @@ namespace plorth
        */
       static std::shared_ptr<input> standard(memory::manager& memory_manager);
 
+      /**
+       * Constructs new input which reads UTF-8 encoded text from given file
+       * descriptor, such as a socket. When green threads have been enabled,
+       * the calling task gives control to other tasks while waiting for data
+       * to arrive. The file descriptor is not closed by the input.
+       */
+      static std::shared_ptr<input> file_descriptor(
+        memory::manager& memory_manager,
+        int fd
+      );
+
       /**
        * Constructs new input which reads nothing.
        */
@@ -46,6 +46,18 @@ namespace plorth
        */
       static std::shared_ptr<output> standard(memory::manager& memory_manager);
 
+      /**
+       * Constructs new output which writes UTF-8 encoded text into given file
+       * descriptor, such as a socket. When the file descriptor is not ready
+       * to accept more data, the calling green thread gives control to other
+       * green threads until it is. The file descriptor is not closed by the
+       * output.
+       */
+      static std::shared_ptr<output> file_descriptor(
+        memory::manager& memory_manager,
+        int fd
+      );
+
       /**
        * Constructs new output which ignores everything that will be written
        * into it.
@@ -30,6 +30,15 @@
 
 #include <cstddef>
 #include <memory>
+#include <new>
+#include <utility>
+#if PLORTH_ENABLE_MEMORY_POOL
+# include <unordered_set>
+#endif
+#if PLORTH_ENABLE_THREADS
+# include <atomic>
+# include <mutex>
+#endif
 
 namespace plorth
 {
@@ -63,27 +72,300 @@ namespace plorth
       /**
        * Allocates memory for a managed object from memory pools of this memory
        * manager. New memory pools are being created when previous ones are
-       * full.
+       * full. Allocations which are too large to fit into an ordinary memory
+       * pool are given a dedicated pool of their own, which is released as
+       * soon as the allocation is.
        *
        * \param size Size of the object to allocate memory for.
        * \return     Pointer to the allocated memory.
        */
       void* allocate(std::size_t size);
 
+      /**
+       * Releases memory previously allocated with the allocate() method back
+       * into the memory pool where it was allocated from. Unlike with managed
+       * objects, no destructor is invoked here.
+       *
+       * \param pointer Pointer to the memory to release.
+       */
+      void deallocate(void* pointer);
+
+      /**
+       * Records an object which has been constructed into memory most
+       * recently allocated with the allocate() method by the calling thread,
+       * so that the object can be destroyed when the memory manager is being
+       * destroyed, even though it was not allocated with the new operator of
+       * managed class.
+       *
+       * \param instance Pointer to the constructed object.
+       * \param destroy  Function which invokes destructor of the object.
+       */
+      void track(void* instance, void (*destroy)(void*));
+
+      /**
+       * Returns true if given object has already been destroyed by the
+       * destructor of the memory manager, in which case it must not be
+       * destroyed again when the last reference to it is released.
+       */
+      bool disposed(const void* instance) const;
+
+      /**
+       * Begins an allocation region. While a region is active, managed
+       * objects are sliced from dedicated arena pools with simple pointer
+       * bumping instead of searching through free slots of the existing
+       * pools. Regions can be nested, in which case only the outermost one
+       * has any effect. While concurrency is in effect, allocations are not
+       * placed into the arena pools.
+       */
+      void begin_region();
+
+      /**
+       * Ends an allocation region. Arena pools whose every object has
+       * already been destroyed are released in bulk, while arena pools that
+       * still contain live objects (i.e. values that escaped the region by
+       * being stored into a dictionary or left on the stack) are promoted
+       * into ordinary memory pools of the manager. Memory of the objects
+       * already destroyed in promoted pools becomes available for reuse.
+       */
+      void end_region();
+
+      /**
+       * Returns true if an allocation region is currently active.
+       */
+      inline bool in_region() const
+      {
+        return m_region_depth > 0;
+      }
+
+      /**
+       * Declares that managed objects may be allocated and released by
+       * multiple threads simultaneously, until end_concurrency() is called.
+       * While concurrency is in effect, all operations of the memory manager
+       * are serialized with a mutex. Outside of it, the memory manager is
+       * only accessed by single thread and no locking takes place.
+       *
+       * Must be called before the other threads are started, and can be
+       * nested.
+       */
+      void begin_concurrency();
+
+      /**
+       * Ends concurrency previously declared with begin_concurrency(). Must be
+       * called after the other threads have stopped using the manager.
+       */
+      void end_concurrency();
+
+      /**
+       * Returns true if the memory manager is currently being accessed by
+       * multiple threads.
+       */
+      inline bool concurrent() const
+      {
+#if PLORTH_ENABLE_THREADS
+        return m_concurrency.load(std::memory_order_acquire) > 0;
+#else
+        return false;
+#endif
+      }
+
       manager(const manager&) = delete;
       manager(manager&&) = delete;
       void operator=(const manager&) = delete;
       void operator=(manager&&) = delete;
 
-#if PLORTH_ENABLE_MEMORY_POOL
     private:
+      void* allocate_unlocked(std::size_t size);
+      void deallocate_unlocked(void* pointer);
+
+    private:
+      /** Number of currently active (nested) allocation regions. */
+      unsigned int m_region_depth;
+#if PLORTH_ENABLE_THREADS
+      /** Number of active begin_concurrency() calls. */
+      std::atomic<unsigned int> m_concurrency;
+      /** Used to serialize access to the manager from multiple threads. */
+      std::mutex m_mutex;
+#endif
+#if PLORTH_ENABLE_MEMORY_POOL
       /** Pointer to the first memory pool used by this manager. */
       pool* m_pool_head;
       /** Pointer to the last memory pool used by this manager. */
       pool* m_pool_tail;
+      /** Pointer to the first arena pool of the active region. */
+      pool* m_region_head;
+      /** Pointer to the last arena pool of the active region. */
+      pool* m_region_tail;
+      /** Empty arena pools kept around for reuse by later regions. */
+      pool* m_recycled_pools;
+      /** Number of pools in the list of recycled arena pools. */
+      std::size_t m_recycled_count;
+      /** Whether the manager is currently being destroyed. */
+      bool m_destroying;
+      /** Objects which have been destroyed by destructor of the manager. */
+      std::unordered_set<const void*> m_disposed;
+
 #endif
     };
 
+    /**
+     * Helper class which begins an allocation region when constructed and
+     * ends it when destroyed. Intended to be placed around compilation and
+     * execution of short scripts, such as a single line of input in the REPL
+     * or a single request in an embedding application.
+     *
+     *     {
+     *       memory::region region(runtime->memory_manager());
+     *
+     *       if (auto script = ctx->compile(source))
+     *       {
+     *         script->call(ctx);
+     *       }
+     *     }
+     */
+    class region
+    {
+    public:
+      explicit region(class manager& manager);
+      ~region();
+
+      region(const region&) = delete;
+      region(region&&) = delete;
+      void operator=(const region&) = delete;
+      void operator=(region&&) = delete;
+
+    private:
+      /** Memory manager whose allocation region this is. */
+      class manager& m_manager;
+    };
+
+    /**
+     * Standard library compatible allocator which allocates memory from
+     * memory pools of a memory manager. Intended to be used with
+     * std::allocate_shared() so that both the managed object and the
+     * reference counter of it are placed into single memory slot.
+     */
+    template< class T >
+    class allocator
+    {
+    public:
+      using value_type = T;
+
+      explicit allocator(class manager& manager)
+        : m_manager(&manager)
+        , m_extra(0)
+        , m_payload(nullptr) {}
+
+      /**
+       * Constructs allocator which reserves given amount of additional bytes
+       * after the allocated object, in the same memory slot. This can be used
+       * for storing variable length data of an object inline. The address of
+       * the additional memory is stored into given pointer once the memory
+       * has been allocated, i.e. before the object is being constructed.
+       *
+       * \param manager Memory manager to allocate the memory from.
+       * \param extra   Number of additional bytes to allocate.
+       * \param payload Pointer where address of the additional memory is
+       *                stored into.
+       */
+      explicit allocator(class manager& manager,
+                         std::size_t extra,
+                         void** payload)
+        : m_manager(&manager)
+        , m_extra(extra)
+        , m_payload(payload) {}
+
+      template< class U >
+      allocator(const allocator<U>& that)
+        : m_manager(that.manager())
+        , m_extra(that.extra())
+        , m_payload(that.payload()) {}
+
+      inline T* allocate(std::size_t n)
+      {
+        std::size_t size = n * sizeof(T);
+        char* memory;
+
+        if (!m_extra)
+        {
+          return static_cast<T*>(m_manager->allocate(size));
+        }
+
+        // Keep the inline payload aligned by 8 bytes, which is also the
+        // alignment of memory slots.
+        size += (8 - size % 8) % 8;
+        memory = static_cast<char*>(m_manager->allocate(size + m_extra));
+        if (m_payload)
+        {
+          *m_payload = static_cast<void*>(memory + size);
+        }
+
+        return reinterpret_cast<T*>(memory);
+      }
+
+      inline void deallocate(T* pointer, std::size_t)
+      {
+        m_manager->deallocate(static_cast<void*>(pointer));
+      }
+
+      template< class U, class... Args >
+      inline void construct(U* pointer, Args&&... args)
+      {
+        ::new (static_cast<void*>(pointer)) U(std::forward<Args>(args)...);
+        m_manager->track(static_cast<void*>(pointer), destroy_instance<U>);
+      }
+
+      template< class U >
+      inline void destroy(U* pointer)
+      {
+        if (!m_manager->disposed(static_cast<const void*>(pointer)))
+        {
+          pointer->~U();
+        }
+      }
+
+      inline class manager* manager() const
+      {
+        return m_manager;
+      }
+
+      inline std::size_t extra() const
+      {
+        return m_extra;
+      }
+
+      inline void** payload() const
+      {
+        return m_payload;
+      }
+
+      template< class U >
+      inline bool operator==(const allocator<U>& that) const
+      {
+        return m_manager == that.manager();
+      }
+
+      template< class U >
+      inline bool operator!=(const allocator<U>& that) const
+      {
+        return m_manager != that.manager();
+      }
+
+    private:
+      template< class U >
+      static void destroy_instance(void* pointer)
+      {
+        static_cast<U*>(pointer)->~U();
+      }
+
+    private:
+      /** Memory manager used for allocating the memory. */
+      class manager* m_manager;
+      /** Number of additional bytes to allocate after the object. */
+      std::size_t m_extra;
+      /** Where address of the additional memory is stored into. */
+      void** m_payload;
+    };
+
     /**
      * Base class for all objects which memory allocation is being handled
      * through a memory manager.
@@ -117,6 +399,17 @@ namespace plorth
 #if PLORTH_ENABLE_MEMORY_POOL
     struct pool
     {
+      /** Memory manager which owns this pool. */
+      class manager* manager;
+      /** Whether this pool is an arena pool of an allocation region. */
+      bool region;
+      /**
+       * Whether this pool has been created for single allocation which is too
+       * large to fit into an ordinary memory pool.
+       */
+      bool large;
+      /** Size of the memory area of this pool in bytes. */
+      std::size_t capacity;
       /** Pointer to the next pool in the memory manager. */
       pool* next;
       /** Pointer to the previous pool in the memory manager. */
@@ -147,6 +440,19 @@ namespace plorth
       std::size_t size;
       /** Pointer to the allocated memory. */
       char* memory;
+      /**
+       * Whether the slot contains an object allocated with the new operator
+       * of managed class, which the memory manager destroys when it's being
+       * destroyed itself.
+       */
+      bool object;
+      /**
+       * Function which destroys object constructed into the slot through an
+       * allocator, or null pointer if there is no such object.
+       */
+      void (*destroy)(void*);
+      /** Pointer to the object constructed into the slot through allocator. */
+      void* instance;
     };
 #endif
   }
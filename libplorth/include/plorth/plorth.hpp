@@ -35,10 +35,14 @@
 #include <plorth/value-number.hpp>
 #include <plorth/value-object.hpp>
 #include <plorth/value-quote.hpp>
+#include <plorth/value-sequence.hpp>
 #include <plorth/value-string.hpp>
 #include <plorth/value-word.hpp>
 
 #include <plorth/runtime.hpp>
 #include <plorth/context.hpp>
+#include <plorth/compiler.hpp>
+#include <plorth/context-pool.hpp>
+#include <plorth/scheduler.hpp>
 
 #endif /* !PLORTH_PLORTH_HPP_GUARD */
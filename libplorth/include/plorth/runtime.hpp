@@ -26,6 +26,7 @@
 #ifndef PLORTH_RUNTIME_HPP_GUARD
 #define PLORTH_RUNTIME_HPP_GUARD
 
+#include <plorth/actor-system.hpp>
 #include <plorth/dictionary.hpp>
 #include <plorth/io-input.hpp>
 #include <plorth/io-output.hpp>
@@ -33,15 +34,20 @@
 #include <plorth/value-array.hpp>
 #include <plorth/value-boolean.hpp>
 #include <plorth/value-number.hpp>
+#include <plorth/value-sequence.hpp>
 #include <plorth/value-string.hpp>
 
+#if PLORTH_ENABLE_THREADS
+# include <mutex>
+#endif
+
 namespace plorth
 {
   class runtime : public memory::managed
   {
   public:
     using prototype_definition = std::vector<
-      std::pair<const char32_t*, quote::callback>
+      std::pair<const char32_t*, quote::signature>
     >;
 #if PLORTH_ENABLE_SYMBOL_CACHE
     using symbol_cache = std::unordered_map<
@@ -73,6 +79,50 @@ namespace plorth
         = std::shared_ptr<module::manager>()
     );
 
+    /**
+     * Constructs new runtime which shares prototypes and built-in words with
+     * an existing base runtime, instead of constructing them again. Words
+     * defined into the global dictionary of the new runtime are layered on
+     * top of the global dictionary of the base runtime, leaving the base
+     * runtime untouched. This makes it cheap to host large amount of
+     * isolated runtimes within single process.
+     *
+     * The base runtime should be treated as frozen once it has been used for
+     * constructing other runtimes; it must not be used for executing scripts
+     * or have it's global dictionary modified while other runtimes share it.
+     *
+     * \param memory_manager Memory manager to use for allocating memory.
+     * \param base           Runtime which prototypes and global dictionary
+     *                       will be shared with the new runtime.
+     * \param input          Input used by the runtime. If omitted, standard
+     *                       input stream of the process will be used.
+     * \param output         Output used by the runtime. If omitted, standard
+     *                       output stream of the process will be used.
+     * \param module_manager Module manager used for importing modules. If
+     *                       omitted, one that will load modules from file
+     *                       system will be used.
+     * \return               Reference to the created runtime.
+     */
+    static std::shared_ptr<runtime> make(
+      memory::manager& memory_manager,
+      const std::shared_ptr<runtime>& base,
+      const std::shared_ptr<io::input>& input
+        = std::shared_ptr<io::input>(),
+      const std::shared_ptr<io::output>& output
+        = std::shared_ptr<io::output>(),
+      const std::shared_ptr<module::manager>& module_manager
+        = std::shared_ptr<module::manager>()
+    );
+
+    /**
+     * Returns the base runtime which prototypes and built-in words this
+     * runtime shares, or null reference if this runtime has no base runtime.
+     */
+    inline const std::shared_ptr<runtime>& base() const
+    {
+      return m_base;
+    }
+
     /**
      * Returns the memory manager used by this scripting runtime.
      */
@@ -81,6 +131,17 @@ namespace plorth
       return *m_memory_manager;
     }
 
+#if PLORTH_ENABLE_THREADS
+    /**
+     * Returns the actor system used for running execution contexts
+     * concurrently.
+     */
+    inline actor_system& actors()
+    {
+      return m_actors;
+    }
+#endif
+
     /**
      * Returns the input used by the runtime.
      */
@@ -206,6 +267,46 @@ namespace plorth
       const std::u32string& path
     );
 
+    /**
+     * Serializes state of the runtime into an image, which can later be
+     * loaded back with the load_image() method in order to skip the
+     * compilation of scripts and modules entirely. The image contains words
+     * defined by scripts into the global dictionary and into the dictionary
+     * of given execution context, as well as contents of the data stack of
+     * the execution context. Built-in words and prototypes are not included,
+     * as the runtime constructs them anyway.
+     *
+     * \param context Execution context which dictionary and data stack will
+     *                be included in the image, and where any errors will be
+     *                placed into.
+     * \param output  Where the serialized image will be placed into.
+     * \return        Boolean flag telling whether the image was successfully
+     *                serialized, or whether it contains values which cannot
+     *                be serialized, such as native quotes.
+     */
+    bool save_image(
+      const std::shared_ptr<class context>& context,
+      std::string& output
+    );
+
+    /**
+     * Restores state of the runtime from an image previously constructed with
+     * the save_image() method.
+     *
+     * \param context Execution context which dictionary and data stack will
+     *                be populated with contents of the image, and where any
+     *                errors will be placed into.
+     * \param input   Pointer to the serialized image.
+     * \param length  Length of the serialized image in bytes.
+     * \return        Boolean flag telling whether the image was successfully
+     *                loaded or not.
+     */
+    bool load_image(
+      const std::shared_ptr<class context>& context,
+      const char* input,
+      std::size_t length
+    );
+
     /**
      * Outputs system specific new line into the output of the interpreter.
      */
@@ -262,6 +363,31 @@ namespace plorth
       const std::vector<object::value_type>& properties
     );
 
+    /**
+     * Constructs sequence which produces elements of given array.
+     *
+     * \param array Array to construct the sequence from.
+     * \return      Reference to the created sequence value.
+     */
+    std::shared_ptr<class sequence> sequence(
+      const std::shared_ptr<class array>& array
+    );
+
+    /**
+     * Constructs sequence which produces numbers starting from given start
+     * value and incrementing by one, for as long as the number is less than
+     * given end value.
+     *
+     * \param start First number of the range.
+     * \param end   Number which ends the range. It is not included in the
+     *              range itself.
+     * \return      Reference to the created sequence value.
+     */
+    std::shared_ptr<class sequence> range(
+      const std::shared_ptr<class number>& start,
+      const std::shared_ptr<class number>& end
+    );
+
     /**
      * Constructs string value from given Unicode string.
      *
@@ -286,11 +412,13 @@ namespace plorth
      * \param id       String which acts as identifier for the symbol.
      * \param position Optional position in source code where the symbol was
      *                 encountered.
+     * \param hash     Optional precomputed hash code of the identifier.
      * \return         Reference to the created symbol.
      */
     std::shared_ptr<class symbol> symbol(
       const std::u32string& id,
-      const struct position* position = nullptr
+      const struct position* position = nullptr,
+      std::size_t hash = 0
     );
 
     /**
@@ -305,6 +433,16 @@ namespace plorth
      */
     std::shared_ptr<quote> native_quote(quote::callback callback);
 
+    /**
+     * Constructs native quote from given plain C++ function.
+     */
+    std::shared_ptr<quote> native_quote(quote::function function);
+
+    /**
+     * Constructs native quote from given signature.
+     */
+    std::shared_ptr<quote> native_quote(const quote::signature& signature);
+
     /**
      * Constructs word from given string and quote.
      */
@@ -323,12 +461,17 @@ namespace plorth
 
     /**
      * Helper method for constructing managed objects (such as values) using
-     * the memory manager associated with this runtime instance.
+     * the memory manager associated with this runtime instance. Both the
+     * object and the reference counter of it are allocated from single
+     * memory slot.
      */
     template< typename T, typename... Args >
-    inline std::shared_ptr<T> value(Args... args)
+    inline std::shared_ptr<T> value(Args&&... args)
     {
-      return std::shared_ptr<T>(new (*m_memory_manager) T(args...));
+      return std::allocate_shared<T>(
+        memory::allocator<T>(*m_memory_manager),
+        std::forward<Args>(args)...
+      );
     }
 
     /**
@@ -404,6 +547,14 @@ namespace plorth
       return m_quote_prototype;
     }
 
+    /**
+     * Returns prototype for sequence values.
+     */
+    inline const std::shared_ptr<class object>& sequence_prototype() const
+    {
+      return m_sequence_prototype;
+    }
+
     /**
      * Returns prototype for string values.
      */
@@ -437,9 +588,22 @@ namespace plorth
      */
     explicit runtime(memory::manager* memory_manager);
 
+    /**
+     * Constructs new runtime which shares prototypes and global dictionary
+     * with given base runtime.
+     *
+     * \param memory_manager Pointer to the memory manager to use for
+     *                       allocating memory.
+     * \param base           Base runtime to share prototypes with.
+     */
+    explicit runtime(memory::manager* memory_manager,
+                     const std::shared_ptr<runtime>& base);
+
   private:
     /** Memory manager associated with this runtime. */
     memory::manager* m_memory_manager;
+    /** Optional base runtime which prototypes are shared by this one. */
+    const std::shared_ptr<runtime> m_base;
     /** Input which the runtime uses. */
     std::shared_ptr<io::input> m_input;
     /** Output which the runtime uses. */
@@ -452,6 +616,17 @@ namespace plorth
     std::shared_ptr<class boolean> m_true_value;
     /** Shared instance of false boolean value. */
     std::shared_ptr<class boolean> m_false_value;
+    /** Shared instance of empty string value. */
+    std::shared_ptr<class string> m_empty_string;
+    /** Shared instance of empty array value. */
+    std::shared_ptr<class array> m_empty_array;
+    /** Shared instance of empty object value. */
+    std::shared_ptr<class object> m_empty_object;
+    /** Shared instances of commonly used real numbers. */
+    std::shared_ptr<class number> m_real_zero;
+    std::shared_ptr<class number> m_real_one;
+    std::shared_ptr<class number> m_real_nan;
+    std::shared_ptr<class number> m_real_infinity;
     /** Prototype for array values. */
     std::shared_ptr<class object> m_array_prototype;
     /** Prototype for boolean values. */
@@ -464,6 +639,8 @@ namespace plorth
     std::shared_ptr<class object> m_object_prototype;
     /** Prototype for quotes. */
     std::shared_ptr<class object> m_quote_prototype;
+    /** Prototype for sequence values. */
+    std::shared_ptr<class object> m_sequence_prototype;
     /** Prototype for string values. */
     std::shared_ptr<class object> m_string_prototype;
     /** Prototype for symbol values. */
@@ -477,8 +654,28 @@ namespace plorth
     symbol_cache m_symbol_cache;
 #endif
 #if PLORTH_ENABLE_INTEGER_CACHE
-    /** Cache for commonly used integer numbers. */
-    std::shared_ptr<class number> m_integer_cache[256];
+    /**
+     * Shared instances of integer numbers between PLORTH_INTEGER_CACHE_MIN
+     * and PLORTH_INTEGER_CACHE_MAX. Populated when the base runtime is
+     * constructed and shared as it is by derived runtimes.
+     */
+    std::shared_ptr<
+      const std::vector<std::shared_ptr<class number>>
+    > m_integer_cache;
+#endif
+#if PLORTH_ENABLE_THREADS
+    /**
+     * Used for protecting the caches when the runtime is being used by
+     * multiple threads simultaneously.
+     */
+    std::mutex m_mutex;
+    /** Used for serializing module imports made by multiple threads. */
+    std::recursive_mutex m_import_mutex;
+    /**
+     * Actor system of the runtime. Declared last, so that actors are joined
+     * before rest of the runtime is destroyed.
+     */
+    actor_system m_actors;
 #endif
   };
 }
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2017-2018, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PLORTH_SCHEDULER_HPP_GUARD
+#define PLORTH_SCHEDULER_HPP_GUARD
+
+#include <plorth/config.hpp>
+
+#if PLORTH_ENABLE_GREEN_THREADS
+# include <cstddef>
+# include <deque>
+# include <memory>
+# include <unordered_map>
+# include <vector>
+#endif
+
+namespace plorth
+{
+  class context;
+  class quote;
+
+#if PLORTH_ENABLE_GREEN_THREADS
+  /**
+   * Cooperative scheduler for green threads. Each thread of the process has
+   * a scheduler of it's own, which multiplexes tasks spawned by that thread
+   * on top of it. Each task executes a quote in an execution context of it's
+   * own, with a call stack of it's own, and gives control to other tasks
+   * when it yields or has to wait for input to become available.
+   *
+   * Tasks may belong to different runtimes, which allows a single thread to
+   * serve multiple interpreter sessions by giving each of them a runtime
+   * with an input of their own.
+   */
+  class scheduler
+  {
+  public:
+    using size_type = std::size_t;
+
+    /** Size of the call stack given to each task, in bytes. */
+    static const size_type stack_size;
+
+    /**
+     * Returns the scheduler of the calling thread.
+     */
+    static scheduler& current();
+
+    /**
+     * Destructor. Tasks which have not been completed are discarded, so
+     * join() should be called before the runtimes of the tasks are
+     * destroyed.
+     */
+    ~scheduler();
+
+    /**
+     * Creates new task which executes given quote in an execution context of
+     * it's own. Words from the local dictionary of the calling context are
+     * copied into the new context. The task is not started until the
+     * calling context yields or waits for input.
+     *
+     * \param ctx   Calling execution context.
+     * \param quote Quote to execute as a task.
+     */
+    void spawn(const std::shared_ptr<context>& ctx,
+               const std::shared_ptr<class quote>& quote);
+
+    /**
+     * Gives control to the next task which is ready to run, if there is one.
+     * The calling task is resumed once other ready tasks have had their
+     * turn.
+     */
+    void yield();
+
+    /**
+     * Suspends the calling task until given file descriptor has input
+     * available for reading, giving control to other tasks in the meantime.
+     * Returns immediately if there are no other tasks which could run.
+     *
+     * \param fd File descriptor to wait for.
+     * \return   Boolean flag telling whether the task was suspended, or
+     *           whether it returned immediately.
+     */
+    bool wait_readable(int fd);
+
+    /**
+     * Suspends the calling task until given file descriptor can be written
+     * into without blocking, giving control to other tasks in the meantime.
+     * Returns immediately if there are no other tasks which could run.
+     *
+     * \param fd File descriptor to wait for.
+     * \return   Boolean flag telling whether the task was suspended, or
+     *           whether it returned immediately.
+     */
+    bool wait_writable(int fd);
+
+    /**
+     * Runs the tasks until all of them have been completed. Must not be
+     * called from within a task.
+     */
+    void join();
+
+    /**
+     * Returns the number of tasks which have not been completed yet.
+     */
+    inline size_type size() const
+    {
+      return m_size;
+    }
+
+    scheduler(const scheduler&) = delete;
+    scheduler(scheduler&&) = delete;
+    void operator=(const scheduler&) = delete;
+    void operator=(scheduler&&) = delete;
+
+  private:
+    struct task;
+
+    /**
+     * Tasks waiting for single file descriptor.
+     */
+    struct waiters
+    {
+      /** Tasks waiting for the file descriptor to become readable. */
+      std::vector<task*> readers;
+      /** Tasks waiting for the file descriptor to become writable. */
+      std::vector<task*> writers;
+    };
+
+    scheduler();
+    static void entry();
+    void schedule();
+    bool wait(int fd, bool writable);
+    void poll(int timeout);
+    void wake(int fd, bool readable, bool writable);
+    void reap();
+
+  private:
+    /** Pseudo task representing the thread itself. */
+    std::unique_ptr<task> m_root;
+    /** Task which is currently running. */
+    task* m_current;
+    /** Tasks which are ready to run, in the order they are resumed. */
+    std::deque<task*> m_ready;
+    /** Tasks waiting for input, indexed by file descriptor. */
+    std::unordered_map<int, waiters> m_waiting;
+    /** Number of tasks waiting for input. */
+    size_type m_waiting_count;
+    /** Completed tasks whose call stacks can be released. */
+    std::vector<task*> m_finished;
+    /** Number of tasks which have not been completed yet. */
+    size_type m_size;
+    /** Whether the root task is waiting for all tasks to complete. */
+    bool m_joining;
+#if HAVE_SYS_EPOLL_H
+    /** Event loop used for waiting for input, or -1 if not created yet. */
+    int m_epoll;
+#endif
+  };
+#endif
+}
+
+#endif /* !PLORTH_SCHEDULER_HPP_GUARD */
@@ -35,16 +35,44 @@
 
 namespace plorth
 {
+  /**
+   * Decodes UTF-8 encoded bytes into Unicode string. Decoding stops at the
+   * first encoding error.
+   *
+   * \param ptr Pointer to array of bytes to decode.
+   * \param len Size of the array.
+   * \return    Decoded Unicode string.
+   */
+  std::u32string utf8_decode(const char*, std::size_t);
+
   /**
    * Decodes UTF-8 encoded byte string into Unicode string. Encountered encoding
    * errors are ignored.
    */
-  std::u32string utf8_decode(const std::string&);
+  inline std::u32string utf8_decode(const std::string& input)
+  {
+    return utf8_decode(input.c_str(), input.length());
+  }
+
+  /**
+   * Decodes UTF-8 encoded bytes with validation and appends the result into
+   * given Unicode string.
+   *
+   * \param ptr    Pointer to array of bytes to decode.
+   * \param len    Size of the array.
+   * \param output Unicode string where decoded characters are appended to.
+   * \return       Boolean flag telling whether the bytes were valid UTF-8.
+   */
+  bool utf8_decode_test(const char*, std::size_t, std::u32string&);
 
   /**
    * Decodes UTF-8 encoded byte string into Unicode string with validation.
    */
-  bool utf8_decode_test(const std::string&, std::u32string&);
+  inline bool utf8_decode_test(const std::string& input,
+                               std::u32string& output)
+  {
+    return utf8_decode_test(input.c_str(), input.length(), output);
+  }
 
   /**
    * Encodes given Unicode characters into UTF-8 encoded byte string.
@@ -121,6 +149,16 @@ namespace plorth
    */
   char32_t unicode_tolower(char32_t);
 
+  /**
+   * Converts array of Unicode characters into upper case, in place.
+   */
+  void unicode_toupper(char32_t*, std::size_t);
+
+  /**
+   * Converts array of Unicode characters into lower case, in place.
+   */
+  void unicode_tolower(char32_t*, std::size_t);
+
   /**
    * Attempts to determine length (in bytes) of UTF-8 sequence which begins
    * with the given byte. If the length cannot be determined (i.e. beginning of
@@ -54,28 +54,51 @@ namespace plorth
       real = 1
     };
 
+    explicit number(int_type value);
+    explicit number(real_type value);
+
     /**
      * Returns type of the number.
      */
-    virtual enum number_type number_type() const = 0;
+    inline enum number_type number_type() const
+    {
+      return m_number_type;
+    }
 
     /**
      * Tests whether this number is of specific type.
      */
     inline bool is(enum number_type t) const
     {
-      return number_type() == t;
+      return m_number_type == t;
     }
 
     /**
-     * Returns value of the number as integer.
+     * Returns value of the number as integer. Real numbers are truncated
+     * towards zero.
      */
-    virtual int_type as_int() const = 0;
+    inline int_type as_int() const
+    {
+      if (m_number_type == number_type::integer)
+      {
+        return m_int_value;
+      }
+
+      return static_cast<int_type>(m_real_value);
+    }
 
     /**
      * Returns value of the number as floating point decimal.
      */
-    virtual real_type as_real() const = 0;
+    inline real_type as_real() const
+    {
+      if (m_number_type == number_type::integer)
+      {
+        return static_cast<real_type>(m_int_value);
+      }
+
+      return m_real_value;
+    }
 
     inline enum type type() const
     {
@@ -85,6 +108,22 @@ namespace plorth
     bool equals(const std::shared_ptr<class value>& that) const;
     std::u32string to_string() const;
     std::u32string to_source() const;
+
+  private:
+    friend void number_store(const std::shared_ptr<class runtime>&,
+                             std::shared_ptr<class value>&,
+                             int_type);
+    friend void number_store(const std::shared_ptr<class runtime>&,
+                             std::shared_ptr<class value>&,
+                             real_type);
+
+  private:
+    enum number_type m_number_type;
+    union
+    {
+      int_type m_int_value;
+      real_type m_real_value;
+    };
   };
 }
 
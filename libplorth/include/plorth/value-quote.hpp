@@ -29,6 +29,7 @@
 #include <plorth/value.hpp>
 
 #include <functional>
+#include <initializer_list>
 
 namespace plorth
 {
@@ -42,6 +43,51 @@ namespace plorth
     /** Signature of C++ function that can be used as quote. */
     using callback = std::function<void(const std::shared_ptr<context>&)>;
 
+    /**
+     * Plain C++ function that can be used as quote. Unlike callbacks, these
+     * are invoked directly without going through type erasure.
+     */
+    using function = void(*)(const std::shared_ptr<context>&);
+
+    /**
+     * C++ function with declared arguments that can be used as quote. The
+     * arguments have already been popped from the stack and type checked
+     * when the function is called, and they are given to it topmost value
+     * first.
+     */
+    using typed_function = void(*)(context&, std::shared_ptr<value>*);
+
+    /** Maximum number of arguments that typed function can declare. */
+    static const std::size_t max_arity = 3;
+
+    /**
+     * Describes how native quote is invoked; either as plain C++ function or
+     * as typed function along with the arguments it takes.
+     */
+    struct signature
+    {
+      /** Plain C++ function, or null if the quote is typed. */
+      quote::function plain;
+      /** Typed C++ function, or null if the quote is plain. */
+      quote::typed_function typed;
+      /** Number of arguments taken by the typed function. */
+      std::size_t arity;
+      /** Number of arguments whose type has been declared. */
+      std::size_t type_count;
+      /**
+       * Types of the arguments, topmost value first. Arguments beyond those
+       * whose type has been declared accept any value.
+       */
+      enum value::type types[max_arity];
+
+      signature(quote::function function);
+
+      signature(quote::typed_function function, std::size_t arity);
+
+      signature(quote::typed_function function,
+                std::initializer_list<enum value::type> types);
+    };
+
     /**
      * Enumeration for different supported quote types.
      */
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2017-2018, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PLORTH_VALUE_SEQUENCE_HPP_GUARD
+#define PLORTH_VALUE_SEQUENCE_HPP_GUARD
+
+#include <memory>
+
+#include <plorth/value.hpp>
+
+namespace plorth
+{
+  /**
+   * Sequence is a lazily evaluated series of values. Unlike elements of an
+   * array, elements of a sequence are produced one at a time while the
+   * sequence is being iterated, so pipelines built from sequences do not
+   * construct intermediate arrays.
+   */
+  class sequence : public value
+  {
+  public:
+    class iterator;
+
+    /**
+     * Constructs new iterator which produces the elements of the sequence,
+     * starting from the first one.
+     */
+    virtual std::unique_ptr<iterator> iterate() const = 0;
+
+    inline enum type type() const
+    {
+      return type::sequence;
+    }
+
+    bool equals(const std::shared_ptr<value>& that) const;
+    std::u32string to_string() const;
+    std::u32string to_source() const;
+  };
+
+  /**
+   * Iterator which produces elements of a sequence one at a time.
+   */
+  class sequence::iterator
+  {
+  public:
+    /**
+     * Enumeration of possible outcomes of advancing the iterator.
+     */
+    enum class result
+    {
+      /** Next element of the sequence was produced. */
+      value,
+      /** Sequence has no more elements. */
+      end,
+      /** Error was set into the execution context. */
+      error
+    };
+
+    virtual ~iterator() {}
+
+    /**
+     * Produces next element of the sequence.
+     *
+     * \param ctx  Execution context used for calling quotes which are part
+     *             of the sequence.
+     * \param slot Where the element will be placed into.
+     * \return     Outcome of the operation.
+     */
+    virtual result next(const std::shared_ptr<context>& ctx,
+                        std::shared_ptr<value>& slot) = 0;
+  };
+}
+
+#endif /* !PLORTH_VALUE_SEQUENCE_HPP_GUARD */
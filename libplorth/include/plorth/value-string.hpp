@@ -59,6 +59,21 @@ namespace plorth
      */
     virtual value_type at(size_type offset) const = 0;
 
+    /**
+     * Returns pointer to the characters of the string if they are stored
+     * sequentially in memory, or null pointer if they are not.
+     */
+    virtual const_pointer data() const;
+
+    /**
+     * Copies range of characters from the string into given buffer.
+     *
+     * \param output Buffer where the characters are copied into.
+     * \param offset Offset of the first character to copy.
+     * \param count  Number of characters to copy.
+     */
+    virtual void copy(pointer output, size_type offset, size_type count) const;
+
     enum type type() const
     {
       return type::string;
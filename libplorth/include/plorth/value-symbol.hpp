@@ -46,9 +46,11 @@ namespace plorth
      * \param id       String which acts as identifier for the symbol.
      * \param position Optional position in source code where the symbol was
      *                 encountered.
+     * \param hash     Optional precomputed hash code of the identifier.
      */
     explicit symbol(const std::u32string& id,
-                    const struct position* position = nullptr);
+                    const struct position* position = nullptr,
+                    std::size_t hash = 0);
 
     /**
      * Destructor.
@@ -64,7 +64,9 @@ namespace plorth
       /** Words. */
       word = 8,
       /** Errors. */
-      error = 9
+      error = 9,
+      /** Lazily evaluated sequences. */
+      sequence = 10
     };
 
     /**
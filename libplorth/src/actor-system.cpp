@@ -0,0 +1,321 @@
+/*
+ * Copyright (c) 2017-2018, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <plorth/context.hpp>
+#include <plorth/scheduler.hpp>
+
+#include <sstream>
+
+#if PLORTH_ENABLE_THREADS
+namespace plorth
+{
+  actor_system::actor_system(class runtime* runtime)
+    : m_runtime(runtime)
+    , m_next_id(1)
+    , m_live(0)
+    , m_waiting(0)
+    , m_closed(false) {}
+
+  actor_system::~actor_system()
+  {
+    join();
+  }
+
+  actor_system::id_type actor_system::spawn(
+    const std::shared_ptr<context>& ctx,
+    const std::shared_ptr<class quote>& quote
+  )
+  {
+    const auto child = context::make(ctx->runtime());
+    std::vector<std::thread> terminated;
+    id_type id;
+
+    // Words are copied instead of layering the dictionary of the new context
+    // on top of the calling one, as the calling context might not outlive
+    // the actor.
+    for (const auto& word : ctx->dictionary().words())
+    {
+      child->dictionary().insert(word);
+    }
+
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+
+      reap(lock, terminated);
+      id = m_next_id++;
+      m_mailboxes[id] = std::make_shared<mailbox>();
+      ++m_live;
+      child->actor_id(id);
+
+      // Memory manager must serialize it's operations for as long as the
+      // actor is running.
+      m_runtime->memory_manager().begin_concurrency();
+      m_threads[id] = std::thread(&actor_system::run, this, id, child, quote);
+    }
+
+    for (auto& thread : terminated)
+    {
+      thread.join();
+    }
+
+    return id;
+  }
+
+  bool actor_system::send(const std::shared_ptr<context>& ctx,
+                          id_type id,
+                          const std::shared_ptr<value>& message)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto entry = m_mailboxes.find(id);
+
+    if (entry == std::end(m_mailboxes))
+    {
+      // Messages sent to terminated actors are silently discarded, but
+      // identifiers which have never been assigned are an error.
+      if (id < 1 || id >= m_next_id)
+      {
+        ctx->error(error::code::range, U"Unknown actor.");
+
+        return false;
+      }
+
+      return true;
+    }
+
+    const auto& mailbox = entry->second;
+
+    mailbox->messages.push_back(message);
+    if (mailbox->waiting)
+    {
+      mailbox->waiting = false;
+      --m_waiting;
+    }
+    mailbox->available.notify_one();
+
+    return true;
+  }
+
+  bool actor_system::receive(const std::shared_ptr<context>& ctx,
+                             std::shared_ptr<value>& slot)
+  {
+    const auto id = self(ctx);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    const auto mailbox = m_mailboxes[id];
+
+    while (mailbox->messages.empty())
+    {
+      if (m_closed)
+      {
+        if (mailbox->waiting)
+        {
+          mailbox->waiting = false;
+          --m_waiting;
+        }
+        ctx->error(error::code::unknown, U"Actor system has been shut down.");
+
+        return false;
+      }
+
+      if (mailbox->external)
+      {
+        // Contexts which are not actors cannot wait for messages when every
+        // actor is waiting for messages as well, as nobody would be there to
+        // send them.
+        if (m_waiting == m_live)
+        {
+          ctx->error(
+            error::code::unknown,
+            U"Deadlock; no actor is able to send messages."
+          );
+
+          return false;
+        }
+      }
+      else if (!mailbox->waiting)
+      {
+        mailbox->waiting = true;
+        ++m_waiting;
+        notify_changed();
+      }
+      mailbox->available.wait(lock);
+    }
+
+    if (mailbox->waiting)
+    {
+      mailbox->waiting = false;
+      --m_waiting;
+    }
+    slot = mailbox->messages.front();
+    mailbox->messages.pop_front();
+
+    return true;
+  }
+
+  actor_system::id_type actor_system::self(const std::shared_ptr<context>& ctx)
+  {
+    id_type id = ctx->actor_id();
+
+    if (!id)
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      const auto mailbox = std::make_shared<struct mailbox>();
+
+      id = m_next_id++;
+      mailbox->external = true;
+      m_mailboxes[id] = mailbox;
+      m_external.push_back(mailbox);
+      ctx->actor_id(id);
+    }
+
+    return id;
+  }
+
+  void actor_system::join()
+  {
+    std::unordered_map<id_type, std::thread> threads;
+
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+
+      m_changed.wait(lock, [this] { return m_waiting == m_live; });
+
+      // Remaining actors are all waiting for messages that will never arrive,
+      // so close the mailboxes, which makes them terminate.
+      if (m_live > 0)
+      {
+        m_closed = true;
+        for (const auto& entry : m_mailboxes)
+        {
+          entry.second->available.notify_all();
+        }
+        m_changed.wait(lock, [this] { return !m_live; });
+        m_closed = false;
+      }
+
+      threads.swap(m_threads);
+      m_terminated.clear();
+    }
+
+    for (auto& entry : threads)
+    {
+      // Runtime can end up being destroyed by the last actor, in which case
+      // it cannot wait for it's own thread.
+      if (entry.second.get_id() == std::this_thread::get_id())
+      {
+        entry.second.detach();
+      } else {
+        entry.second.join();
+      }
+    }
+  }
+
+  void actor_system::run(actor_system* system,
+                         id_type id,
+                         std::shared_ptr<context> ctx,
+                         std::shared_ptr<class quote> quote)
+  {
+    auto& memory_manager = ctx->runtime()->memory_manager();
+
+    system->execute(id, std::move(ctx), std::move(quote));
+
+    // The context and the quote have been destroyed by now, so this thread
+    // no longer touches the memory manager.
+    memory_manager.end_concurrency();
+  }
+
+  /**
+   * Writes uncaught error of an actor into the output of the runtime, in the
+   * same format as the command line interpreter uses for uncaught errors.
+   */
+  static void report_error(const std::shared_ptr<context>& ctx)
+  {
+    const std::shared_ptr<error>& err = ctx->error();
+    std::ostringstream out;
+
+    out << "Error: ";
+    if (err)
+    {
+      const auto position = err->position();
+
+      if (position && (!position->filename.empty() || position->line))
+      {
+        out << *position << ':';
+      }
+      out << err->code() << " - " << utf8_encode(err->message());
+    } else {
+      out << "Unknown error.";
+    }
+
+    ctx->runtime()->println(utf8_decode(out.str()));
+  }
+
+  void actor_system::execute(id_type id,
+                             std::shared_ptr<context> ctx,
+                             std::shared_ptr<class quote> quote)
+  {
+    // Uncaught errors terminate the actor and are reported to the output of
+    // the runtime, as there is nobody else to catch them.
+    if (!quote->call(ctx))
+    {
+      report_error(ctx);
+    }
+#if PLORTH_ENABLE_GREEN_THREADS
+    scheduler::current().join();
+#endif
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_mailboxes.erase(id);
+    m_terminated.push_back(id);
+    --m_live;
+    notify_changed();
+  }
+
+  void actor_system::reap(std::unique_lock<std::mutex>&,
+                          std::vector<std::thread>& threads)
+  {
+    for (const auto id : m_terminated)
+    {
+      const auto entry = m_threads.find(id);
+
+      if (entry != std::end(m_threads))
+      {
+        threads.push_back(std::move(entry->second));
+        m_threads.erase(entry);
+      }
+    }
+    m_terminated.clear();
+  }
+
+  void actor_system::notify_changed()
+  {
+    m_changed.notify_all();
+    for (const auto& mailbox : m_external)
+    {
+      mailbox->available.notify_all();
+    }
+  }
+}
+#endif
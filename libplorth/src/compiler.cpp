@@ -23,179 +23,919 @@
  * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
  * POSSIBILITY OF SUCH DAMAGE.
  */
-#include <plorth/context.hpp>
-#include <plorth/parser.hpp>
+#include <plorth/compiler.hpp>
+
+#include <unordered_map>
 
 namespace plorth
 {
-  static std::shared_ptr<value> compile_token(
-    const std::shared_ptr<runtime>&,
-    const std::shared_ptr<token>&
-  );
-
-  std::shared_ptr<quote> context::compile(const std::u32string& source,
-                                          const std::u32string& filename,
-                                          int line,
-                                          int column)
+  namespace
   {
-    class parser parser(source, filename, line, column);
-    std::vector<std::shared_ptr<token>> result;
-    std::vector<std::shared_ptr<value>> values;
+    /**
+     * Returns true if given ASCII character can be part of a symbol. This is
+     * equivalent to unicode_isword() for characters below U+0080.
+     */
+    static inline bool is_word_byte(unsigned char c)
+    {
+      return c > 0x20 && c < 0x7f && c != '(' && c != ')' && c != '['
+        && c != ']' && c != '{' && c != '}' && c != ':' && c != ';'
+        && c != ',';
+    }
 
-    if (!parser.parse(result))
+    static inline bool is_space_byte(unsigned char c)
     {
-      auto error_message = parser.error();
+      return c == ' ' || (c >= '\t' && c <= '\r');
+    }
 
-      if (error_message.empty())
+    static inline bool is_hex_byte(unsigned char c)
+    {
+      return (c >= '0' && c <= '9')
+        || (c >= 'a' && c <= 'f')
+        || (c >= 'A' && c <= 'F');
+    }
+
+    /**
+     * Decodes single UTF-8 encoded character from given input.
+     *
+     * \param input Pointer to beginning of the UTF-8 sequence.
+     * \param end   End of the input.
+     * \param c     Where the decoded character is stored into.
+     * \return      Length of the UTF-8 sequence in bytes, or 0 if the
+     *              sequence is malformed.
+     */
+    static inline std::size_t decode(const unsigned char* input,
+                                     const unsigned char* end,
+                                     char32_t& c)
+    {
+      std::size_t length;
+
+      if (*input < 0x80)
+      {
+        c = *input;
+
+        return 1;
+      }
+      length = utf8_sequence_length(*input);
+      if (!length || static_cast<std::size_t>(end - input) < length)
       {
-        error_message = U"Unknown error.";
+        return 0;
+      }
+      c = *input & (0xff >> (length + 1));
+      for (std::size_t i = 1; i < length; ++i)
+      {
+        if ((input[i] & 0xc0) != 0x80)
+        {
+          return 0;
+        }
+        c = (c << 6) | (input[i] & 0x3f);
       }
-      error(error::code::syntax, error_message, &parser.position());
 
-      return std::shared_ptr<quote>();
+      return length;
     }
-    values.reserve(result.size());
-    for (const auto& token : result)
+
+    /**
+     * Single pass compiler which constructs values directly from UTF-8
+     * encoded source code, without building an intermediate syntax tree.
+     */
+    class compiler
     {
-      values.push_back(compile_token(m_runtime, token));
-    }
+    public:
+      explicit compiler(class context& ctx,
+                        const unsigned char* begin,
+                        const unsigned char* end,
+                        const std::u32string& filename,
+                        int line,
+                        int column)
+        : m_context(ctx)
+        , m_runtime(ctx.runtime())
+        , m_current(begin)
+        , m_end(end)
+      {
+        m_position.filename = filename;
+        m_position.line = line;
+        m_position.column = column;
+      }
 
-    return m_runtime->compiled_quote(values);
+      bool compile(std::vector<std::shared_ptr<value>>& container)
+      {
+        std::shared_ptr<value> slot;
+
+        while (!skip_whitespace())
+        {
+          if (!compile_value(slot))
+          {
+            return false;
+          }
+          container.push_back(std::move(slot));
+        }
+
+        return true;
+      }
+
+    private:
+      /**
+       * Identifier which has already been decoded and hashed once during the
+       * compilation.
+       */
+      struct interned_symbol
+      {
+        std::u32string id;
+        std::size_t hash;
+      };
+
+      inline bool eof() const
+      {
+        return m_current >= m_end;
+      }
+
+      inline bool peek(unsigned char expected) const
+      {
+        return !eof() && *m_current == expected;
+      }
+
+      /**
+       * Advances past given character which is encoded with given amount of
+       * bytes, while keeping track of line and column numbers.
+       */
+      inline void advance(char32_t c, std::size_t length = 1)
+      {
+        m_current += length;
+        if (c == '\n')
+        {
+          ++m_position.line;
+          m_position.column = 1;
+        } else {
+          ++m_position.column;
+        }
+      }
+
+      inline bool peek_advance(unsigned char expected)
+      {
+        if (peek(expected))
+        {
+          advance(expected);
+
+          return true;
+        }
+
+        return false;
+      }
+
+      bool syntax_error(const std::u32string& message)
+      {
+        m_context.error(error::code::syntax, message, &m_position);
+
+        return false;
+      }
+
+      bool decode_error()
+      {
+        m_context.error(
+          error::code::import,
+          U"Unable to decode source code as UTF-8.",
+          &m_position
+        );
+
+        return false;
+      }
+
+      /**
+       * Skips whitespace and comments from the source code.
+       *
+       * \return True if end of input has been reached, false otherwise.
+       */
+      bool skip_whitespace()
+      {
+        while (!eof())
+        {
+          // Skip line comments.
+          if (peek_advance('#'))
+          {
+            while (!eof())
+            {
+              if (peek_advance('\n') || peek_advance('\r'))
+              {
+                break;
+              }
+              // Continuation bytes of UTF-8 sequences do not advance the
+              // column.
+              if ((*m_current++ & 0xc0) != 0x80)
+              {
+                ++m_position.column;
+              }
+            }
+          }
+          else if (!is_space_byte(*m_current))
+          {
+            return false;
+          } else {
+            advance(*m_current);
+          }
+        }
+
+        return true;
+      }
+
+      bool compile_value(std::shared_ptr<value>& slot)
+      {
+        if (skip_whitespace())
+        {
+          return syntax_error(U"Unexpected end of input; Missing value.");
+        }
+        switch (*m_current)
+        {
+          case '"':
+          case '\'':
+            if (!compile_string(m_buffer))
+            {
+              return false;
+            }
+            slot = m_runtime->string(m_buffer);
+
+            return true;
+
+          case '(':
+            return compile_quote(slot);
+
+          case '[':
+            return compile_array(slot);
+
+          case '{':
+            return compile_object(slot);
+
+          case ':':
+            return compile_word(slot);
+
+          default:
+            {
+              std::shared_ptr<class symbol> symbol;
+
+              if (!compile_symbol(symbol))
+              {
+                return false;
+              }
+              slot = std::move(symbol);
+
+              return true;
+            }
+        }
+      }
+
+      bool compile_array(std::shared_ptr<value>& slot)
+      {
+        const auto mark = m_stack.size();
+        std::shared_ptr<value> element;
+
+        advance('[');
+        for (;;)
+        {
+          if (skip_whitespace())
+          {
+            return syntax_error(U"Unterminated array; Missing `]'.");
+          }
+          else if (peek_advance(']'))
+          {
+            break;
+          }
+          else if (!compile_value(element))
+          {
+            return false;
+          }
+          m_stack.push_back(std::move(element));
+          if (skip_whitespace() || (!peek(',') && !peek(']')))
+          {
+            return syntax_error(U"Unterminated array; Missing `]'.");
+          }
+          peek_advance(',');
+        }
+        slot = m_runtime->array(m_stack.data() + mark, m_stack.size() - mark);
+        m_stack.resize(mark);
+
+        return true;
+      }
+
+      bool compile_object(std::shared_ptr<value>& slot)
+      {
+        std::vector<object::value_type> properties;
+
+        advance('{');
+        for (;;)
+        {
+          if (skip_whitespace())
+          {
+            return syntax_error(U"Unterminated object; Missing `}'.");
+          }
+          else if (peek_advance('}'))
+          {
+            break;
+          }
+          else if (!peek('"') && !peek('\''))
+          {
+            return syntax_error(U"Unexpected input; Missing string.");
+          }
+          else if (!compile_string(m_buffer))
+          {
+            return false;
+          }
+          properties.push_back(object::value_type(
+            m_buffer,
+            std::shared_ptr<value>()
+          ));
+          if (skip_whitespace())
+          {
+            return syntax_error(U"Unterminated object; Missing `}'.");
+          }
+          else if (!peek_advance(':'))
+          {
+            return syntax_error(U"Missing `:' after property key.");
+          }
+          else if (!compile_value(properties.back().second))
+          {
+            return false;
+          }
+          if (skip_whitespace() || (!peek(',') && !peek('}')))
+          {
+            return syntax_error(U"Unterminated object; Missing `}'.");
+          }
+          peek_advance(',');
+        }
+        slot = m_runtime->object(properties);
+
+        return true;
+      }
+
+      /**
+       * Compiles values until given terminator character is encountered and
+       * constructs compiled quote from them.
+       */
+      bool compile_quote_body(unsigned char terminator,
+                              const char32_t* error_message,
+                              std::shared_ptr<quote>& slot)
+      {
+        const auto mark = m_stack.size();
+        std::shared_ptr<value> child;
+
+        for (;;)
+        {
+          if (skip_whitespace())
+          {
+            return syntax_error(error_message);
+          }
+          else if (peek_advance(terminator))
+          {
+            break;
+          }
+          else if (!compile_value(child))
+          {
+            return false;
+          }
+          m_stack.push_back(std::move(child));
+        }
+        slot = m_runtime->compiled_quote(std::vector<std::shared_ptr<value>>(
+          std::begin(m_stack) + mark,
+          std::end(m_stack)
+        ));
+        m_stack.resize(mark);
+
+        return true;
+      }
+
+      bool compile_quote(std::shared_ptr<value>& slot)
+      {
+        std::shared_ptr<quote> quote;
+
+        advance('(');
+        if (!compile_quote_body(')',
+                                U"Unterminated quote; Missing `)'.",
+                                quote))
+        {
+          return false;
+        }
+        slot = std::move(quote);
+
+        return true;
+      }
+
+      bool compile_word(std::shared_ptr<value>& slot)
+      {
+        std::shared_ptr<class symbol> symbol;
+        std::shared_ptr<quote> quote;
+
+        advance(':');
+        if (!compile_symbol(symbol) ||
+            !compile_quote_body(';',
+                                U"Unterminated word; Missing `;'.",
+                                quote))
+        {
+          return false;
+        }
+        slot = m_runtime->word(symbol, quote);
+
+        return true;
+      }
+
+      bool compile_string(std::u32string& buffer)
+      {
+        const unsigned char separator = *m_current;
+        std::size_t length;
+        char32_t c;
+
+        advance(separator);
+        buffer.clear();
+        for (;;)
+        {
+          if (eof())
+          {
+            return syntax_error(
+              std::u32string(U"Unterminated string; Missing `")
+              + static_cast<char32_t>(separator)
+              + U"'."
+            );
+          }
+          else if (peek_advance(separator))
+          {
+            break;
+          }
+          else if (peek_advance('\\'))
+          {
+            if (!compile_escape_sequence(buffer))
+            {
+              return false;
+            }
+          }
+          else if (!(length = decode(m_current, m_end, c)))
+          {
+            return decode_error();
+          } else {
+            buffer.append(1, c);
+            advance(c, length);
+          }
+        }
+
+        return true;
+      }
+
+      bool compile_escape_sequence(std::u32string& buffer)
+      {
+        std::size_t length;
+        char32_t c;
+
+        if (eof())
+        {
+          return syntax_error(
+            U"Unexpected end of input; Missing escape sequence."
+          );
+        }
+        else if (!(length = decode(m_current, m_end, c)))
+        {
+          return decode_error();
+        }
+        advance(c, length);
+        switch (c)
+        {
+          case 'b':
+            buffer.append(1, 010);
+            break;
+
+          case 't':
+            buffer.append(1, 011);
+            break;
+
+          case 'n':
+            buffer.append(1, 012);
+            break;
+
+          case 'f':
+            buffer.append(1, 014);
+            break;
+
+          case 'r':
+            buffer.append(1, 015);
+            break;
+
+          case '"':
+          case '\'':
+          case '\\':
+          case '/':
+            buffer.append(1, c);
+            break;
+
+          case 'u':
+            {
+              char32_t result = 0;
+
+              for (int i = 0; i < 4; ++i)
+              {
+                if (eof())
+                {
+                  return syntax_error(U"Unterminated escape sequence.");
+                }
+                else if (!is_hex_byte(*m_current))
+                {
+                  return syntax_error(U"Illegal Unicode hex escape sequence.");
+                }
+                c = *m_current;
+                advance(c);
+                if (c >= 'A' && c <= 'F')
+                {
+                  result = result * 16 + (c - 'A' + 10);
+                }
+                else if (c >= 'a' && c <= 'f')
+                {
+                  result = result * 16 + (c - 'a' + 10);
+                } else {
+                  result = result * 16 + (c - '0');
+                }
+              }
+
+              if (!unicode_validate(result))
+              {
+                return syntax_error(U"Illegal Unicode hex escape sequence.");
+              }
+
+              buffer.append(1, result);
+            }
+            break;
+
+          default:
+            return syntax_error(U"Illegal escape sequence in string literal.");
+        }
+
+        return true;
+      }
+
+      bool compile_symbol(std::shared_ptr<class symbol>& slot)
+      {
+        const unsigned char* end;
+        const interned_symbol* interned;
+        int length = 0;
+        std::size_t sequence_length;
+        char32_t c;
+
+        if (skip_whitespace())
+        {
+          return syntax_error(U"Unexpected end of input; Missing symbol.");
+        }
+
+        // Find the end of the symbol first, so that position of the symbol
+        // does not have to be copied. Symbols cannot contain line breaks.
+        for (end = m_current; end < m_end; end += sequence_length, ++length)
+        {
+          if (*end < 0x80)
+          {
+            if (!is_word_byte(*end))
+            {
+              break;
+            }
+            sequence_length = 1;
+          }
+          else if (!(sequence_length = decode(end, m_end, c)))
+          {
+            m_current = end;
+            m_position.column += length;
+
+            return decode_error();
+          }
+          else if (!unicode_isword(c))
+          {
+            break;
+          }
+        }
+
+        if (!length)
+        {
+          return syntax_error(U"Unexpected input; Missing symbol.");
+        }
+
+        interned = &intern(m_current, end);
+        slot = m_runtime->symbol(interned->id, &m_position, interned->hash);
+        m_current = end;
+        m_position.column += length;
+
+        return true;
+      }
+
+      /**
+       * Decodes given identifier, unless it has already been encountered
+       * earlier during the compilation.
+       */
+      const interned_symbol& intern(const unsigned char* begin,
+                                    const unsigned char* end)
+      {
+        const std::string key(
+          reinterpret_cast<const char*>(begin),
+          end - begin
+        );
+        auto entry = m_symbols.find(key);
+
+        if (entry == std::end(m_symbols))
+        {
+          interned_symbol symbol;
+
+          symbol.id = utf8_decode(key);
+          symbol.hash = std::hash<std::u32string>()(symbol.id);
+          entry = m_symbols.emplace(key, std::move(symbol)).first;
+        }
+
+        return entry->second;
+      }
+
+      compiler(const compiler&) = delete;
+      compiler(compiler&&) = delete;
+      void operator=(const compiler&) = delete;
+      void operator=(compiler&&) = delete;
+
+    private:
+      /** Execution context where syntax errors are reported to. */
+      class context& m_context;
+      /** Runtime used for constructing the values. */
+      const std::shared_ptr<class runtime>& m_runtime;
+      /** Current position in the source code. */
+      const unsigned char* m_current;
+      /** End of the source code. */
+      const unsigned char* const m_end;
+      /** Line and column number tracking. */
+      struct position m_position;
+      /** Values of arrays and quotes which are currently being compiled. */
+      std::vector<std::shared_ptr<value>> m_stack;
+      /** Identifiers already encountered during the compilation. */
+      std::unordered_map<std::string, interned_symbol> m_symbols;
+      /** Reusable buffer for string literals. */
+      std::u32string m_buffer;
+    };
   }
 
-  static std::shared_ptr<array> compile_array_token(
-    const std::shared_ptr<class runtime>& runtime,
-    const std::shared_ptr<token::array>& token
-  )
+  std::shared_ptr<quote> context::compile(const char* source,
+                                          std::size_t length,
+                                          const std::u32string& filename,
+                                          int line,
+                                          int column)
   {
-    const auto& elements = token->elements();
-    const auto size = elements.size();
-    std::shared_ptr<value> result[size];
+    const auto begin = reinterpret_cast<const unsigned char*>(source);
+    compiler compiler(*this, begin, begin + length, filename, line, column);
+    std::vector<std::shared_ptr<value>> values;
 
-    for (std::size_t i = 0; i < size; ++i)
+    if (!compiler.compile(values))
     {
-      result[i] = compile_token(runtime, elements[i]);
+      return std::shared_ptr<quote>();
     }
 
-    return runtime->array(result, size);
+    return m_runtime->compiled_quote(values);
   }
 
-  static std::shared_ptr<object> compile_object_token(
-    const std::shared_ptr<class runtime>& runtime,
-    const std::shared_ptr<token::object>& token
-  )
+  std::shared_ptr<quote> context::compile(const std::u32string& source,
+                                          const std::u32string& filename,
+                                          int line,
+                                          int column)
   {
-    const auto& properties = token->properties();
-    const auto size = properties.size();
-    std::vector<object::value_type> result;
+    const auto bytes = utf8_encode(source);
 
-    result.reserve(size);
-    for (std::size_t i = 0; i < size; ++i)
-    {
-      const auto& property = properties[i];
+    return compile(bytes.c_str(), bytes.length(), filename, line, column);
+  }
 
-      result.push_back(object::value_type(
-        property.first,
-        compile_token(runtime, property.second)
-      ));
-    }
+  incremental_compiler::incremental_compiler(const std::u32string& filename,
+                                             int line,
+                                             int column)
+    : m_filename(filename)
+    , m_scanned(0)
+    , m_boundary(0)
+    , m_line(line)
+    , m_column(column)
+    , m_boundary_line(line)
+    , m_boundary_column(column)
+    , m_scan_line(line)
+    , m_scan_column(column)
+    , m_state(state::none)
+    , m_separator(0) {}
 
-    return runtime->object(result);
+  bool incremental_compiler::pending() const
+  {
+    return !m_frames.empty()
+      || m_state == state::string
+      || m_state == state::escape;
   }
 
-  static std::shared_ptr<quote> compile_quote_token(
-    const std::shared_ptr<class runtime>& runtime,
-    const std::shared_ptr<token::quote>& token
-  )
+  bool incremental_compiler::feed(const std::shared_ptr<context>& ctx,
+                                  const char* chunk,
+                                  std::size_t length,
+                                  std::shared_ptr<quote>& slot)
   {
-    const auto& children = token->children();
-    const auto size = children.size();
-    std::vector<std::shared_ptr<value>> result;
-
-    result.reserve(size);
-    for (std::size_t i = 0; i < size; ++i)
+    slot.reset();
+    m_buffer.append(chunk, length);
+    scan();
+    if (!m_boundary)
+    {
+      return true;
+    }
+    else if (!compile(ctx, m_boundary, slot))
     {
-      result.push_back(compile_token(runtime, children[i]));
+      return false;
     }
+    m_buffer.erase(0, m_boundary);
+    m_scanned -= m_boundary;
+    m_boundary = 0;
+    m_line = m_boundary_line;
+    m_column = m_boundary_column;
 
-    return runtime->compiled_quote(result);
+    return true;
   }
 
-  static std::shared_ptr<string> compile_string_token(
-    const std::shared_ptr<class runtime>& runtime,
-    const std::shared_ptr<token::string>& token
-  )
+  bool incremental_compiler::finish(const std::shared_ptr<context>& ctx,
+                                    std::shared_ptr<quote>& slot)
   {
-    return runtime->string(token->value());
-  }
+    const bool result = compile(ctx, m_buffer.length(), slot);
 
-  static std::shared_ptr<symbol> compile_symbol_token(
-    const std::shared_ptr<class runtime>& runtime,
-    const std::shared_ptr<token::symbol>& token
-  )
-  {
-    return runtime->symbol(token->id(), &token->position());
+    reset();
+
+    return result;
   }
 
-  static std::shared_ptr<word> compile_word_token(
-    const std::shared_ptr<class runtime>& runtime,
-    const std::shared_ptr<token::word>& token
-  )
+  void incremental_compiler::reset()
   {
-    return runtime->word(
-      compile_symbol_token(runtime, token->symbol()),
-      compile_quote_token(runtime, token->quote())
-    );
+    m_buffer.clear();
+    m_scanned = 0;
+    m_boundary = 0;
+    m_line = m_boundary_line = m_scan_line;
+    m_column = m_boundary_column = m_scan_column;
+    m_state = state::none;
+    m_frames.clear();
   }
 
-  static std::shared_ptr<value> compile_token(
-    const std::shared_ptr<class runtime>& runtime,
-    const std::shared_ptr<token>& token
-  )
+  bool incremental_compiler::compile(const std::shared_ptr<context>& ctx,
+                                     std::size_t length,
+                                     std::shared_ptr<quote>& slot)
   {
-    if (!token)
+    if (!(slot = ctx->compile(m_buffer.c_str(),
+                              length,
+                              m_filename,
+                              m_line,
+                              m_column)))
     {
-      return std::shared_ptr<value>();
+      reset();
+
+      return false;
     }
-    switch (token->type())
+
+    return true;
+  }
+
+  /**
+   * Scans the source code which has been appended into the buffer since the
+   * last call, keeping track of where the last completed top level value
+   * ends. Objects use three different frames: `{' when a property key is
+   * expected, `:' when separator after the key is expected and `}' when
+   * property value is expected. The scanner only needs to find the end of
+   * values; syntax errors are left for the compiler to report.
+   */
+  void incremental_compiler::scan()
+  {
+    const auto length = m_buffer.length();
+
+    while (m_scanned < length)
     {
-      case token::type::array:
-        return compile_array_token(
-          runtime,
-          std::static_pointer_cast<token::array>(token)
-        );
+      const unsigned char c = m_buffer[m_scanned];
+      bool completed = false;
 
-      case token::type::object:
-        return compile_object_token(
-          runtime,
-          std::static_pointer_cast<token::object>(token)
-        );
+      switch (m_state)
+      {
+        case state::symbol:
+          if (c >= 0x80 || is_word_byte(c))
+          {
+            break;
+          }
+          m_state = state::none;
+          if (m_frames.empty())
+          {
+            m_boundary = m_scanned;
+            m_boundary_line = m_scan_line;
+            m_boundary_column = m_scan_column;
+          }
+          // Scan the character again as it's not part of the symbol.
+          continue;
 
-      case token::type::quote:
-        return compile_quote_token(
-          runtime,
-          std::static_pointer_cast<token::quote>(token)
-        );
+        case state::string:
+          if (c == '\\')
+          {
+            m_state = state::escape;
+          }
+          else if (c == static_cast<unsigned char>(m_separator))
+          {
+            m_state = state::none;
+            if (m_frames.empty())
+            {
+              completed = true;
+            }
+            else if (m_frames.back() == '{')
+            {
+              m_frames.back() = ':';
+            }
+          }
+          break;
 
-      case token::type::string:
-        return compile_string_token(
-          runtime,
-          std::static_pointer_cast<token::string>(token)
-        );
+        case state::escape:
+          m_state = state::string;
+          break;
 
-      case token::type::symbol:
-        return compile_symbol_token(
-          runtime,
-          std::static_pointer_cast<token::symbol>(token)
-        );
+        case state::comment:
+          if (c == '\n' || c == '\r')
+          {
+            m_state = state::none;
+          }
+          break;
 
-      case token::type::word:
-        return compile_word_token(
-          runtime,
-          std::static_pointer_cast<token::word>(token)
-        );
-    }
+        case state::none:
+          switch (c)
+          {
+            case '#':
+              m_state = state::comment;
+              break;
+
+            case '"':
+            case '\'':
+              m_state = state::string;
+              m_separator = c;
+              break;
+
+            case '(':
+              m_frames.push_back(')');
+              break;
+
+            case '[':
+              m_frames.push_back(']');
+              break;
+
+            case '{':
+              m_frames.push_back('{');
+              break;
+
+            case ':':
+              if (!m_frames.empty() && m_frames.back() == ':')
+              {
+                m_frames.back() = '}';
+              } else {
+                m_frames.push_back(';');
+              }
+              break;
 
-    return std::shared_ptr<value>();
+            case ',':
+              if (m_frames.empty())
+              {
+                completed = true;
+              }
+              else if (m_frames.back() == '}')
+              {
+                m_frames.back() = '{';
+              }
+              break;
+
+            case ')':
+            case ']':
+            case '}':
+            case ';':
+              if (!m_frames.empty()
+                  && (m_frames.back() == static_cast<char>(c)
+                    || (c == '}' && (m_frames.back() == '{'
+                                     || m_frames.back() == ':'))))
+              {
+                m_frames.pop_back();
+                completed = m_frames.empty();
+              } else {
+                // Mismatched closing character is a syntax error, which is
+                // reported immediately instead of waiting for more input.
+                m_frames.clear();
+                completed = true;
+              }
+              break;
+
+            default:
+              if (c >= 0x80 || is_word_byte(c))
+              {
+                m_state = state::symbol;
+              }
+              else if (!is_space_byte(c) && m_frames.empty())
+              {
+                completed = true;
+              }
+          }
+          break;
+      }
+
+      ++m_scanned;
+      if (c == '\n')
+      {
+        ++m_scan_line;
+        m_scan_column = 1;
+      }
+      else if ((c & 0xc0) != 0x80)
+      {
+        ++m_scan_column;
+      }
+      if (completed)
+      {
+        m_boundary = m_scanned;
+        m_boundary_line = m_scan_line;
+        m_boundary_column = m_scan_column;
+      }
+    }
   }
 }
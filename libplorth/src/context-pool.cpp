@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2017-2018, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <plorth/context-pool.hpp>
+
+#include <algorithm>
+
+namespace plorth
+{
+  const context_pool::size_type context_pool::default_max_size = 64;
+
+  context_pool::context_pool(const std::shared_ptr<class runtime>& runtime,
+                             const class dictionary& dictionary_template,
+                             size_type max_size)
+    : m_runtime(runtime)
+    , m_dictionary_template(
+        std::make_shared<const class dictionary>(dictionary_template)
+      )
+    , m_max_size(max_size)
+  {
+    m_contexts.reserve(max_size);
+  }
+
+  std::shared_ptr<context> context_pool::acquire()
+  {
+    std::shared_ptr<context> ctx;
+
+    if (m_contexts.empty())
+    {
+      return context::make(m_runtime, m_dictionary_template);
+    }
+    ctx.swap(m_contexts.back());
+    m_contexts.pop_back();
+
+    return ctx;
+  }
+
+  void context_pool::release(const std::shared_ptr<context>& ctx)
+  {
+    if (!ctx || m_contexts.size() >= m_max_size)
+    {
+      return;
+    }
+    ctx->reset();
+    m_contexts.push_back(ctx);
+  }
+
+  void context_pool::reserve(size_type size)
+  {
+    size = std::min(size, m_max_size);
+    while (m_contexts.size() < size)
+    {
+      m_contexts.push_back(context::make(m_runtime, m_dictionary_template));
+    }
+  }
+}
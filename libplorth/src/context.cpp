@@ -28,6 +28,10 @@
 
 #include "./utils.hpp"
 
+#if PLORTH_ENABLE_INLINE_CACHE && !defined(PLORTH_INLINE_CACHE_SIZE)
+# define PLORTH_INLINE_CACHE_SIZE 256
+#endif
+
 namespace plorth
 {
   std::shared_ptr<context> context::make(
@@ -39,8 +43,76 @@ namespace plorth
     ));
   }
 
-  context::context(const std::shared_ptr<class runtime>& runtime)
-    : m_runtime(runtime) {}
+  std::shared_ptr<context> context::make(
+    const std::shared_ptr<class runtime>& runtime,
+    const std::shared_ptr<const class dictionary>& dictionary_template
+  )
+  {
+    return std::shared_ptr<context>(new (runtime->memory_manager()) context(
+      runtime,
+      dictionary_template
+    ));
+  }
+
+  context::context(
+    const std::shared_ptr<class runtime>& runtime,
+    const std::shared_ptr<const class dictionary>& dictionary_template
+  )
+    : m_runtime(runtime)
+    , m_dictionary_template(dictionary_template)
+    , m_dictionary(dictionary_template.get())
+    , m_depth(0)
+#if PLORTH_ENABLE_THREADS
+    , m_actor_id(0)
+#endif
+    {}
+
+  void context::reset()
+  {
+    m_error.reset();
+    m_data.clear();
+    m_dictionary.clear();
+#if PLORTH_ENABLE_FILE_SYSTEM_MODULES
+    m_filename.clear();
+#endif
+    m_position.filename.clear();
+    m_position.line = 0;
+    m_position.column = 0;
+    m_frames.clear();
+    m_depth = 0;
+    m_tail_call.reset();
+    // Entries of the inline cache do not have to be cleared, as clearing the
+    // local dictionary gives it a new generation which none of the entries
+    // match with.
+#if PLORTH_ENABLE_THREADS
+    m_actor_id = 0;
+#endif
+  }
+
+#if PLORTH_ENABLE_INLINE_CACHE
+  context::inline_cache_entry& context::inline_cache(
+    const class symbol* symbol
+  )
+  {
+    const auto address = reinterpret_cast<std::uintptr_t>(symbol);
+
+    if (!m_inline_cache)
+    {
+      m_inline_cache.reset(
+        new inline_cache_entry[PLORTH_INLINE_CACHE_SIZE]()
+      );
+    }
+
+    // Fibonacci hashing of the address, ignoring the low bits which are
+    // always the same due to alignment.
+    return m_inline_cache[
+      static_cast<std::size_t>(
+        (static_cast<std::uint64_t>(address >> 4) * 0x9e3779b97f4a7c15ULL)
+        >> 32
+      ) % PLORTH_INLINE_CACHE_SIZE
+    ];
+  }
+#endif
 
   void context::error(enum error::code code,
                       const std::u32string& message,
@@ -257,6 +329,11 @@ namespace plorth
     return typed_context_pop<quote>(this, slot, value::type::quote);
   }
 
+  bool context::pop_sequence(std::shared_ptr<sequence>& slot)
+  {
+    return typed_context_pop<sequence>(this, slot, value::type::sequence);
+  }
+
   bool context::pop_symbol(std::shared_ptr<symbol>& slot)
   {
     return typed_context_pop<symbol>(this, slot, value::type::symbol);
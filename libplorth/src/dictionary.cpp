@@ -25,16 +25,47 @@
  */
 #include <plorth/dictionary.hpp>
 
+#include "./peephole.hpp"
+#include "./utils.hpp"
+
+#include <atomic>
+
 namespace plorth
 {
-  dictionary::dictionary() {}
+  /**
+   * Returns next unused dictionary generation.
+   */
+  static std::uint64_t next_generation()
+  {
+    static std::atomic<std::uint64_t> counter(0);
+
+    return ++counter;
+  }
+
+  dictionary::dictionary()
+    : m_parent(nullptr)
+    , m_shadows_builtins(false)
+    , m_generation(next_generation()) {}
+
+  dictionary::dictionary(const dictionary* parent)
+    : m_parent(parent)
+    , m_shadows_builtins(false)
+    , m_generation(next_generation()) {}
 
   dictionary::dictionary(const dictionary& that)
-    : m_words(that.m_words) {}
+    : m_parent(that.m_parent)
+    , m_words(that.m_words)
+    , m_builtins(that.m_builtins)
+    , m_shadows_builtins(that.m_shadows_builtins)
+    , m_generation(next_generation()) {}
 
   dictionary& dictionary::operator=(const dictionary& that)
   {
+    m_parent = that.m_parent;
     m_words = that.m_words;
+    m_builtins = that.m_builtins;
+    m_shadows_builtins = that.m_shadows_builtins;
+    m_generation = next_generation();
 
     return *this;
   }
@@ -46,11 +77,40 @@ namespace plorth
     return find(id->id());
   }
 
+  dictionary::size_type dictionary::size() const
+  {
+    auto result = m_words.size();
+
+    if (m_parent)
+    {
+      for (const auto& word : m_parent->words())
+      {
+        if (m_words.find(word->symbol()->id()) == std::end(m_words))
+        {
+          ++result;
+        }
+      }
+    }
+
+    return result;
+  }
+
   std::vector<dictionary::value_type> dictionary::words() const
   {
     std::vector<value_type> result;
 
     result.reserve(m_words.size());
+    if (m_parent)
+    {
+      // Words from the parent dictionary, unless overridden by this one.
+      for (const auto& word : m_parent->words())
+      {
+        if (m_words.find(word->symbol()->id()) == std::end(m_words))
+        {
+          result.push_back(word);
+        }
+      }
+    }
     for (const auto& entry : m_words)
     {
       result.push_back(entry.second);
@@ -65,7 +125,7 @@ namespace plorth
 
     if (entry == std::end(m_words))
     {
-      return value_type();
+      return m_parent ? m_parent->find(id) : value_type();
     } else {
       return entry->second;
     }
@@ -73,6 +133,31 @@ namespace plorth
 
   void dictionary::insert(const value_type& word)
   {
-    m_words[word->symbol()->id()] = word;
+    const auto& id = word->symbol()->id();
+
+    if (peephole::is_fused_word(id) || is_number(id))
+    {
+      m_shadows_builtins = true;
+    }
+    m_words[id] = word;
+    m_generation = next_generation();
+  }
+
+  void dictionary::clear()
+  {
+    m_words.clear();
+    m_builtins.clear();
+    m_shadows_builtins = false;
+    m_generation = next_generation();
+  }
+
+  void dictionary::mark_builtins()
+  {
+    m_builtins.clear();
+    for (const auto& entry : m_words)
+    {
+      m_builtins.insert(entry.second);
+    }
+    m_shadows_builtins = false;
   }
 }
@@ -75,42 +75,57 @@ namespace plorth
   static bool exec_sym(const std::shared_ptr<context>& ctx,
                        const std::shared_ptr<symbol>& sym)
   {
-    const auto position = sym->position();
-    const auto id = sym->id();
+    std::shared_ptr<quote> callee;
 
-    // Update source code position of the context, if the symbol has such
-    // information.
-    if (position)
+    if (!resolve_symbol(ctx, sym, callee))
     {
-      ctx->position() = *position;
+      return false;
     }
 
+    return !callee || callee->call(ctx);
+  }
+
+  /**
+   * Looks up given symbol from the prototype of the topmost value of the
+   * data stack, from the local and global dictionaries, and finally attempts
+   * to convert it into a number.
+   *
+   * \param ctx       Execution context.
+   * \param sym       Symbol to look up.
+   * \param prototype Prototype of the topmost value of the data stack.
+   * \param callee    Where quote is stored into, if the symbol resolves into
+   *                  one.
+   * \param slot      Otherwise where the resolved value is stored into.
+   * \return          Boolean flag telling whether the symbol was found or
+   *                  not.
+   */
+  static bool lookup_symbol(const std::shared_ptr<context>& ctx,
+                            const std::shared_ptr<symbol>& sym,
+                            const std::shared_ptr<object>& prototype,
+                            std::shared_ptr<quote>& callee,
+                            std::shared_ptr<value>& slot)
+  {
+    const auto& runtime = ctx->runtime();
+    const auto& id = sym->id();
+
     // Look for prototype of the current item.
+    if (prototype && prototype->property(runtime, id, slot))
     {
-      const auto& stack = ctx->data();
-
-      if (!stack.empty() && stack.back())
+      if (value::is(slot, value::type::quote))
       {
-        const auto prototype = stack.back()->prototype(ctx->runtime());
-        std::shared_ptr<value> val;
-
-        if (prototype && prototype->property(ctx->runtime(), id, val))
-        {
-          if (value::is(val, value::type::quote))
-          {
-            return std::static_pointer_cast<quote>(val)->call(ctx);
-          }
-          ctx->push(val);
-
-          return true;
-        }
+        callee = std::static_pointer_cast<quote>(slot);
+        slot.reset();
       }
+
+      return true;
     }
 
     // Look for a word from dictionary of current context.
     if (auto word = ctx->dictionary().find(sym))
     {
-      return word->quote()->call(ctx);
+      callee = word->quote();
+
+      return true;
     }
 
     // TODO: If not found, see if it's a "fully qualified" name, e.g. a name
@@ -118,15 +133,17 @@ namespace plorth
     // for that from the specified namespace.
 
     // Look from global dictionary.
-    if (auto word = ctx->runtime()->dictionary().find(sym))
+    if (auto word = runtime->dictionary().find(sym))
     {
-      return word->quote()->call(ctx);
+      callee = word->quote();
+
+      return true;
     }
 
     // If the name of the word can be converted into number, then do just that.
     if (is_number(id))
     {
-      ctx->push_number(id);
+      slot = runtime->number(id);
 
       return true;
     }
@@ -137,6 +154,113 @@ namespace plorth
     return false;
   }
 
+#if PLORTH_ENABLE_INLINE_CACHE
+  /**
+   * Tests whether given quote consists of single value which evaluates into
+   * itself, such as the quotes declared with the `const' word, in which case
+   * the value is stored into given slot.
+   */
+  static bool is_constant_quote(const std::shared_ptr<quote>& quote,
+                                std::shared_ptr<value>& slot)
+  {
+    const auto values = compiled_quote_values(quote);
+
+    if (!values || values->size() != 1)
+    {
+      return false;
+    }
+    if (const auto& val = values->front())
+    {
+      switch (val->type())
+      {
+        case value::type::array:
+        case value::type::object:
+        case value::type::symbol:
+        case value::type::word:
+          return false;
+
+        default:
+          break;
+      }
+    }
+    slot = values->front();
+
+    return true;
+  }
+#endif
+
+  bool resolve_symbol(const std::shared_ptr<context>& ctx,
+                      const std::shared_ptr<symbol>& sym,
+                      std::shared_ptr<quote>& callee)
+  {
+    const auto position = sym->position();
+    const auto& stack = ctx->data();
+    std::shared_ptr<object> prototype;
+    std::shared_ptr<value> slot;
+
+    // Update source code position of the context, if the symbol has such
+    // information.
+    if (position)
+    {
+      ctx->position() = *position;
+    }
+
+    if (!stack.empty() && stack.back())
+    {
+      prototype = stack.back()->prototype(ctx->runtime());
+    }
+
+#if PLORTH_ENABLE_INLINE_CACHE
+    auto& entry = ctx->inline_cache(sym.get());
+    const auto local_generation = ctx->dictionary().generation();
+    const auto global_generation = ctx->runtime()->dictionary().generation();
+
+    // Reuse result of previous lookup, unless something which could affect
+    // it has changed since.
+    if (entry.symbol == sym
+        && entry.prototype == prototype
+        && entry.local_generation == local_generation
+        && entry.global_generation == global_generation)
+    {
+      if (entry.callee)
+      {
+        callee = entry.callee;
+      } else {
+        ctx->push(entry.value);
+      }
+
+      return true;
+    }
+#endif
+
+    if (!lookup_symbol(ctx, sym, prototype, callee, slot))
+    {
+      return false;
+    }
+
+#if PLORTH_ENABLE_INLINE_CACHE
+    // Words which only push a constant are replaced with the constant, so
+    // that no call needs to be made.
+    if (callee && is_constant_quote(callee, slot))
+    {
+      callee.reset();
+    }
+    entry.symbol = sym;
+    entry.prototype = std::move(prototype);
+    entry.local_generation = local_generation;
+    entry.global_generation = global_generation;
+    entry.callee = callee;
+    entry.value = slot;
+#endif
+
+    if (!callee)
+    {
+      ctx->push(slot);
+    }
+
+    return true;
+  }
+
   static bool exec_wrd(const std::shared_ptr<context>& ctx,
                        const std::shared_ptr<word>& wrd)
   {
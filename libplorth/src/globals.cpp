@@ -24,6 +24,10 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 #include <plorth/context.hpp>
+#include <plorth/scheduler.hpp>
+
+#include "./io-file.hpp"
+#include "./json.hpp"
 
 #include <cmath>
 #include <chrono>
@@ -175,9 +179,9 @@ namespace plorth
    *
    *     1 drop #=> empty stack
    */
-  static void w_drop(const std::shared_ptr<context>& ctx)
+  static void w_drop(context&, std::shared_ptr<value>*)
   {
-    ctx->pop();
+    // Arguments have already been removed from the stack.
   }
 
   /**
@@ -191,12 +195,9 @@ namespace plorth
    *
    *     1 2 3 2drop #=> 1
    */
-  static void w_drop2(const std::shared_ptr<context>& ctx)
+  static void w_drop2(context&, std::shared_ptr<value>*)
   {
-    if (ctx->pop())
-    {
-      ctx->pop();
-    }
+    // Arguments have already been removed from the stack.
   }
 
   /**
@@ -213,15 +214,10 @@ namespace plorth
    *
    *     1 dup #=> 1 1
    */
-  static void w_dup(const std::shared_ptr<context>& ctx)
+  static void w_dup(context& ctx, std::shared_ptr<value>* arguments)
   {
-    std::shared_ptr<class value> value;
-
-    if (ctx->pop(value))
-    {
-      ctx->push(value);
-      ctx->push(value);
-    }
+    ctx.push(arguments[0]);
+    ctx.push(std::move(arguments[0]));
   }
 
   /**
@@ -241,18 +237,12 @@ namespace plorth
    *
    *     1 2 2dup #=> 1 2 1 2
    */
-  static void w_dup2(const std::shared_ptr<context>& ctx)
+  static void w_dup2(context& ctx, std::shared_ptr<value>* arguments)
   {
-    std::shared_ptr<value> a;
-    std::shared_ptr<value> b;
-
-    if (ctx->pop(a) && ctx->pop(b))
-    {
-      ctx->push(b);
-      ctx->push(a);
-      ctx->push(b);
-      ctx->push(a);
-    }
+    ctx.push(arguments[1]);
+    ctx.push(arguments[0]);
+    ctx.push(std::move(arguments[1]));
+    ctx.push(std::move(arguments[0]));
   }
 
   /**
@@ -269,14 +259,9 @@ namespace plorth
    *
    *     1 2 nip #=> 2
    */
-  static void w_nip(const std::shared_ptr<context>& ctx)
+  static void w_nip(context& ctx, std::shared_ptr<value>* arguments)
   {
-    std::shared_ptr<class value> value;
-
-    if (ctx->pop(value) && ctx->pop())
-    {
-      ctx->push(value);
-    }
+    ctx.push(std::move(arguments[0]));
   }
 
   /**
@@ -296,17 +281,11 @@ namespace plorth
    *
    *     1 2 over #=> 1 2 1
    */
-  static void w_over(const std::shared_ptr<context>& ctx)
+  static void w_over(context& ctx, std::shared_ptr<value>* arguments)
   {
-    std::shared_ptr<value> a;
-    std::shared_ptr<value> b;
-
-    if (ctx->pop(a) && ctx->pop(b))
-    {
-      ctx->push(b);
-      ctx->push(a);
-      ctx->push(b);
-    }
+    ctx.push(arguments[1]);
+    ctx.push(std::move(arguments[0]));
+    ctx.push(std::move(arguments[1]));
   }
 
   /**
@@ -326,18 +305,11 @@ namespace plorth
    *
    *     1 2 3 rot #=> 2 3 1
    */
-  static void w_rot(const std::shared_ptr<context>& ctx)
+  static void w_rot(context& ctx, std::shared_ptr<value>* arguments)
   {
-    std::shared_ptr<value> a;
-    std::shared_ptr<value> b;
-    std::shared_ptr<value> c;
-
-    if (ctx->pop(a) && ctx->pop(b) && ctx->pop(c))
-    {
-      ctx->push(b);
-      ctx->push(a);
-      ctx->push(c);
-    }
+    ctx.push(std::move(arguments[1]));
+    ctx.push(std::move(arguments[0]));
+    ctx.push(std::move(arguments[2]));
   }
 
   /**
@@ -355,16 +327,10 @@ namespace plorth
    *
    *     1 2 swap #=> 2 1
    */
-  static void w_swap(const std::shared_ptr<context>& ctx)
+  static void w_swap(context& ctx, std::shared_ptr<value>* arguments)
   {
-    std::shared_ptr<value> a;
-    std::shared_ptr<value> b;
-
-    if (ctx->pop(a) && ctx->pop(b))
-    {
-      ctx->push(a);
-      ctx->push(b);
-    }
+    ctx.push(std::move(arguments[0]));
+    ctx.push(std::move(arguments[1]));
   }
 
   /**
@@ -384,17 +350,11 @@ namespace plorth
    *
    *     1 2 tuck #=> 2 1 2
    */
-  static void w_tuck(const std::shared_ptr<context>& ctx)
+  static void w_tuck(context& ctx, std::shared_ptr<value>* arguments)
   {
-    std::shared_ptr<value> a;
-    std::shared_ptr<value> b;
-
-    if (ctx->pop(a) && ctx->pop(b))
-    {
-      ctx->push(a);
-      ctx->push(b);
-      ctx->push(a);
-    }
+    ctx.push(arguments[0]);
+    ctx.push(std::move(arguments[1]));
+    ctx.push(std::move(arguments[0]));
   }
 
   static inline void type_test(const std::shared_ptr<context>& ctx,
@@ -558,6 +518,23 @@ namespace plorth
     }
   }
 
+  /**
+   * Word: sequence?
+   *
+   * Takes:
+   * - any
+   *
+   * Gives:
+   * - any
+   * - boolean
+   *
+   * Returns true if the topmost value of the stack is a sequence.
+   */
+  static void w_is_sequence(const std::shared_ptr<context>& ctx)
+  {
+    type_test(ctx, value::type::sequence);
+  }
+
   /**
    * Word: string?
    *
@@ -824,6 +801,30 @@ namespace plorth
     }
   }
 
+  /**
+   * Word: >json
+   *
+   * Takes:
+   * - any
+   *
+   * Gives:
+   * - string
+   *
+   * Converts the topmost value of the stack into JSON. Value error will be
+   * thrown if the value contains anything else than objects, arrays, strings,
+   * finite numbers, booleans or null values.
+   */
+  static void w_to_json(const std::shared_ptr<context>& ctx)
+  {
+    std::shared_ptr<class value> value;
+    std::u32string output;
+
+    if (ctx->pop(value) && json::stringify(ctx, value, output))
+    {
+      ctx->push_string(output);
+    }
+  }
+
   /**
    * Word: 1array
    *
@@ -918,6 +919,34 @@ namespace plorth
     }
   }
 
+  /**
+   * Word: range
+   *
+   * Takes:
+   * - number
+   * - number
+   *
+   * Gives:
+   * - sequence
+   *
+   * Constructs sequence of numbers which starts from the first number and
+   * increments by one until the second number is reached. The second number
+   * itself is not included in the sequence. Numbers of the sequence are
+   * produced only when the sequence is iterated.
+   *
+   *     0 5 range >array  #=> [0, 1, 2, 3, 4]
+   */
+  static void w_range(const std::shared_ptr<context>& ctx)
+  {
+    std::shared_ptr<number> start;
+    std::shared_ptr<number> end;
+
+    if (ctx->pop_number(end) && ctx->pop_number(start))
+    {
+      ctx->push(ctx->runtime()->range(start, end));
+    }
+  }
+
   /**
    * Word: if
    *
@@ -934,7 +963,7 @@ namespace plorth
 
     if (ctx->pop_quote(quote) && ctx->pop_boolean(condition) && condition)
     {
-      quote->call(ctx);
+      ctx->tail_call(quote);
     }
   }
 
@@ -961,12 +990,7 @@ namespace plorth
       return;
     }
 
-    if (condition)
-    {
-      then_quote->call(ctx);
-    } else {
-      else_quote->call(ctx);
-    }
+    ctx->tail_call(condition ? then_quote : else_quote);
   }
 
   /**
@@ -1077,13 +1101,27 @@ namespace plorth
   {
     std::shared_ptr<string> source;
     std::shared_ptr<class quote> quote;
+    std::string encoded;
+    const unsigned char* bytes;
+    std::size_t length;
 
     if (!ctx->pop_string(source))
     {
       return;
     }
 
-    quote = ctx->compile(source->to_string());
+#if PLORTH_ENABLE_FILE_IO
+    // Contents of files are already encoded in UTF-8, so they can be
+    // compiled as they are.
+    if (!io::encoded_bytes(source, bytes, length))
+#endif
+    {
+      encoded = utf8_encode(source->to_string());
+      bytes = reinterpret_cast<const unsigned char*>(encoded.data());
+      length = encoded.length();
+    }
+
+    quote = ctx->compile(reinterpret_cast<const char*>(bytes), length);
     if (quote)
     {
       ctx->push(quote);
@@ -1458,6 +1496,111 @@ namespace plorth
     }
   }
 
+#if PLORTH_ENABLE_FILE_IO
+  /**
+   * Word: open
+   *
+   * Takes:
+   * - string
+   *
+   * Gives:
+   * - object
+   *
+   * Opens file from given path for reading and returns an object which can
+   * be used for reading contents of the file line by line. The object has
+   * following methods:
+   *
+   * - `read-line` which returns next line from the file without the line
+   *   terminator, or null if end of the file has been reached.
+   * - `close` which releases the file.
+   *
+   * I/O error will be thrown if the file cannot be opened.
+   */
+  static void w_open(const std::shared_ptr<context>& ctx)
+  {
+    std::shared_ptr<string> path;
+    std::shared_ptr<object> file;
+
+    if (ctx->pop_string(path)
+        && (file = io::open_file(ctx, path->to_string())))
+    {
+      ctx->push(file);
+    }
+  }
+
+  /**
+   * Word: read-file
+   *
+   * Takes:
+   * - string
+   *
+   * Gives:
+   * - string
+   *
+   * Reads contents of file from given path, decodes them as UTF-8 encoded
+   * text and returns the result. Large files are mapped into memory instead
+   * of being read, and characters are decoded only when they are accessed.
+   * I/O error will be thrown if the file cannot be read or decoded.
+   */
+  static void w_read_file(const std::shared_ptr<context>& ctx)
+  {
+    std::shared_ptr<string> path;
+    std::shared_ptr<string> contents;
+
+    if (ctx->pop_string(path)
+        && (contents = io::read_file(ctx, path->to_string())))
+    {
+      ctx->push(contents);
+    }
+  }
+
+  /**
+   * Word: read-lines
+   *
+   * Takes:
+   * - string
+   *
+   * Gives:
+   * - array<string>
+   *
+   * Reads contents of file from given path and returns them as an array of
+   * lines, without the line terminators. I/O error will be thrown if the file
+   * cannot be read or decoded.
+   */
+  static void w_read_lines(const std::shared_ptr<context>& ctx)
+  {
+    std::shared_ptr<string> path;
+    std::vector<std::shared_ptr<value>> lines;
+
+    if (ctx->pop_string(path) && io::read_lines(ctx, path->to_string(), lines))
+    {
+      ctx->push_array(lines.data(), lines.size());
+    }
+  }
+
+  /**
+   * Word: write-file
+   *
+   * Takes:
+   * - string
+   * - string
+   *
+   * Writes the second string into file whose path is given as the topmost
+   * string, encoded as UTF-8. Previous contents of the file are replaced. I/O
+   * error will be thrown if the file cannot be written.
+   */
+  static void w_write_file(const std::shared_ptr<context>& ctx)
+  {
+    std::shared_ptr<string> path;
+    std::shared_ptr<string> contents;
+
+    if (ctx->pop_string(path) && ctx->pop_string(contents))
+    {
+      io::write_file(ctx, path->to_string(), contents);
+    }
+  }
+#endif
+
   /**
    * Word: now
    *
@@ -1474,6 +1617,122 @@ namespace plorth
     ctx->push_int(std::chrono::duration_cast<std::chrono::seconds>(timestamp).count());
   }
 
+#if PLORTH_ENABLE_GREEN_THREADS
+  /**
+   * Word: go
+   *
+   * Takes:
+   * - quote
+   *
+   * Starts executing given quote as a green thread, in an execution context
+   * of it's own. Words defined in the calling context are copied into the new
+   * context. Green threads are run by the same thread as the calling context
+   * and only run while other green threads yield or wait for input.
+   */
+  static void w_go(const std::shared_ptr<context>& ctx)
+  {
+    std::shared_ptr<quote> quo;
+
+    if (ctx->pop_quote(quo))
+    {
+      scheduler::current().spawn(ctx, quo);
+    }
+  }
+
+  /**
+   * Word: yield
+   *
+   * Gives other green threads a chance to run before continuing.
+   */
+  static void w_yield(const std::shared_ptr<context>& ctx)
+  {
+    scheduler::current().yield();
+  }
+#endif
+
+#if PLORTH_ENABLE_THREADS
+  /**
+   * Word: spawn
+   *
+   * Takes:
+   * - quote
+   *
+   * Gives:
+   * - number
+   *
+   * Executes given quote as an actor, in an execution context of it's own
+   * which is run concurrently with the calling one. Words defined in the
+   * calling context are copied into the new context. Identifier of the actor
+   * is placed on the stack, which can be used for sending messages to it.
+   */
+  static void w_spawn(const std::shared_ptr<context>& ctx)
+  {
+    std::shared_ptr<quote> quo;
+
+    if (ctx->pop_quote(quo))
+    {
+      ctx->push_int(ctx->runtime()->actors().spawn(ctx, quo));
+    }
+  }
+
+  /**
+   * Word: send
+   *
+   * Takes:
+   * - any
+   * - number
+   *
+   * Places given value into the mailbox of actor identified by the topmost
+   * number. Messages sent to actors which have terminated are discarded.
+   * Range error will be thrown if no actor has ever had the identifier.
+   */
+  static void w_send(const std::shared_ptr<context>& ctx)
+  {
+    std::shared_ptr<number> id;
+    std::shared_ptr<value> message;
+
+    if (ctx->pop_number(id) && ctx->pop(message))
+    {
+      ctx->runtime()->actors().send(ctx, id->as_int(), message);
+    }
+  }
+
+  /**
+   * Word: receive
+   *
+   * Gives:
+   * - any
+   *
+   * Removes the oldest message from the mailbox of the execution context and
+   * places it on the stack, waiting for one to arrive if the mailbox is
+   * empty. Unknown error will be thrown if the message can never arrive
+   * because every actor is waiting for messages as well.
+   */
+  static void w_receive(const std::shared_ptr<context>& ctx)
+  {
+    std::shared_ptr<value> message;
+
+    if (ctx->runtime()->actors().receive(ctx, message))
+    {
+      ctx->push(message);
+    }
+  }
+
+  /**
+   * Word: self
+   *
+   * Gives:
+   * - number
+   *
+   * Returns the actor identifier of the execution context, which other
+   * actors can use for sending messages to it.
+   */
+  static void w_self(const std::shared_ptr<context>& ctx)
+  {
+    ctx->push_int(ctx->runtime()->actors().self(ctx));
+  }
+#endif
+
   /**
    * Word: =
    *
@@ -1540,15 +1799,15 @@ namespace plorth
         { U"nop", w_nop },
         { U"clear", w_clear },
         { U"depth", w_depth },
-        { U"drop", w_drop },
-        { U"2drop", w_drop2 },
-        { U"dup", w_dup },
-        { U"2dup", w_dup2 },
-        { U"nip", w_nip },
-        { U"over", w_over },
-        { U"rot", w_rot },
-        { U"swap", w_swap },
-        { U"tuck", w_tuck },
+        { U"drop", { w_drop, 1 } },
+        { U"2drop", { w_drop2, 2 } },
+        { U"dup", { w_dup, 1 } },
+        { U"2dup", { w_dup2, 2 } },
+        { U"nip", { w_nip, 2 } },
+        { U"over", { w_over, 2 } },
+        { U"rot", { w_rot, 3 } },
+        { U"swap", { w_swap, 2 } },
+        { U"tuck", { w_tuck, 2 } },
 
         // Value types.
         { U"array?", w_is_array },
@@ -1558,6 +1817,7 @@ namespace plorth
         { U"number?", w_is_number },
         { U"object?", w_is_object },
         { U"quote?", w_is_quote },
+        { U"sequence?", w_is_sequence },
         { U"string?", w_is_string },
         { U"symbol?", w_is_symbol },
         { U"word?", w_is_word },
@@ -1569,11 +1829,13 @@ namespace plorth
         { U">boolean", w_to_boolean },
         { U">string", w_to_string },
         { U">source", w_to_source },
+        { U">json", w_to_json },
 
         // Constructors.
         { U"1array", w_1array },
         { U"2array", w_2array },
         { U"narray", w_narray },
+        { U"range", w_range },
 
         // Logic.
         { U"if", w_if },
@@ -1604,9 +1866,31 @@ namespace plorth
         { U"println", w_println },
         { U"emit", w_emit },
 
+#if PLORTH_ENABLE_FILE_IO
+        // File system.
+        { U"open", w_open },
+        { U"read-file", w_read_file },
+        { U"read-lines", w_read_lines },
+        { U"write-file", w_write_file },
+#endif
+
         // Random utilities.
         { U"now", w_now },
 
+#if PLORTH_ENABLE_GREEN_THREADS
+        // Green threads.
+        { U"go", w_go },
+        { U"yield", w_yield },
+#endif
+
+#if PLORTH_ENABLE_THREADS
+        // Actors.
+        { U"spawn", w_spawn },
+        { U"send", w_send },
+        { U"receive", w_receive },
+        { U"self", w_self },
+#endif
+
         // Global operators.
         { U"=", w_eq },
         { U"!=", w_ne },
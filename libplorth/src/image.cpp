@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2017-2018, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <plorth/context.hpp>
+
+#include "./serialization.hpp"
+#include "./utils.hpp"
+
+namespace plorth
+{
+  /** Magic bytes found in the beginning of each runtime image. */
+  static const char image_magic[] = "PLORTHI";
+  /** Version of the runtime image format. */
+  static const std::uint64_t image_format = 1;
+
+  static bool write_dictionary(serialization::writer&,
+                               const dictionary&,
+                               bool);
+  static bool read_dictionary(serialization::reader&, dictionary&);
+
+  bool runtime::save_image(const std::shared_ptr<class context>& context,
+                           std::string& output)
+  {
+    serialization::writer writer(output);
+    const auto& data = context->data();
+
+    writer.write_bytes(image_magic, sizeof(image_magic));
+    writer.write_uint(image_format);
+    writer.write_string(PLORTH_VERSION);
+
+    // Built-in words from the global dictionary are skipped, as the runtime
+    // constructs them anyway.
+    if (!write_dictionary(writer, m_dictionary, true)
+        || !write_dictionary(writer, context->dictionary(), false))
+    {
+      context->error(
+        error::code::value,
+        U"Unable to serialize words into an image."
+      );
+
+      return false;
+    }
+
+    writer.write_uint(data.size());
+    for (const auto& value : data)
+    {
+      if (!writer.write_value(value))
+      {
+        context->error(
+          error::code::value,
+          U"Unable to serialize data stack into an image."
+        );
+
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  bool runtime::load_image(const std::shared_ptr<class context>& context,
+                           const char* input,
+                           std::size_t length)
+  {
+    serialization::reader reader(context->runtime(), input, length);
+    std::u32string version;
+    std::uint64_t format;
+    std::uint64_t size;
+    std::vector<std::shared_ptr<class value>> data;
+
+    if (!reader.expect_bytes(image_magic, sizeof(image_magic))
+        || !reader.read_uint(format)
+        || format != image_format
+        || !reader.read_string(version)
+        || version != PLORTH_VERSION)
+    {
+      context->error(
+        error::code::import,
+        U"Image has been created with different version of Plorth."
+      );
+
+      return false;
+    }
+
+    if (!read_dictionary(reader, m_dictionary)
+        || !read_dictionary(reader, context->dictionary())
+        || !reader.read_uint(size)
+        || size > length)
+    {
+      context->error(error::code::import, U"Malformed image.");
+
+      return false;
+    }
+
+    data.reserve(size);
+    while (size--)
+    {
+      std::shared_ptr<class value> value;
+
+      if (!reader.read_value(value))
+      {
+        context->error(error::code::import, U"Malformed image.");
+
+        return false;
+      }
+      data.push_back(value);
+    }
+    if (!reader.eof())
+    {
+      context->error(error::code::import, U"Malformed image.");
+
+      return false;
+    }
+
+    for (const auto& value : data)
+    {
+      context->push(value);
+    }
+
+    return true;
+  }
+
+  static bool write_dictionary(serialization::writer& writer,
+                               const dictionary& dictionary,
+                               bool skip_builtins)
+  {
+    std::vector<dictionary::value_type> words;
+
+    for (const auto& word : dictionary.words())
+    {
+      if (!skip_builtins || !dictionary.is_builtin(word))
+      {
+        words.push_back(word);
+      }
+    }
+
+    writer.write_uint(words.size());
+    for (const auto& word : words)
+    {
+      if (!writer.write_value(word))
+      {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  static bool read_dictionary(serialization::reader& reader,
+                              dictionary& dictionary)
+  {
+    std::uint64_t size;
+
+    if (!reader.read_uint(size))
+    {
+      return false;
+    }
+
+    while (size--)
+    {
+      std::shared_ptr<value> word;
+
+      if (!reader.read_value(word) || !value::is(word, value::type::word))
+      {
+        return false;
+      }
+      dictionary.insert(std::static_pointer_cast<class word>(word));
+    }
+
+    return true;
+  }
+}
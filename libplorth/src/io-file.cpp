@@ -0,0 +1,611 @@
+/*
+ * Copyright (c) 2017-2018, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "./io-file.hpp"
+
+#if PLORTH_ENABLE_FILE_IO
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#if HAVE_UNISTD_H && HAVE_SYS_MMAN_H
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+#if !defined(PLORTH_FILE_MAP_THRESHOLD)
+# define PLORTH_FILE_MAP_THRESHOLD (64 * 1024)
+#endif
+
+namespace plorth
+{
+  namespace
+  {
+    /**
+     * Raw contents of a file, which are either mapped into memory or read
+     * into a buffer.
+     */
+    class file_contents
+    {
+    public:
+      file_contents()
+        : m_data(nullptr)
+        , m_size(0)
+        , m_mapped(false) {}
+
+      ~file_contents()
+      {
+#if HAVE_UNISTD_H && HAVE_SYS_MMAN_H
+        if (m_mapped)
+        {
+          ::munmap(const_cast<unsigned char*>(m_data), m_size);
+        }
+#endif
+      }
+
+      /**
+       * Maps or reads contents of given file.
+       */
+      bool load(const std::string& path)
+      {
+#if HAVE_UNISTD_H && HAVE_SYS_MMAN_H
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat st;
+
+        if (fd < 0)
+        {
+          return false;
+        }
+        if (::fstat(fd, &st) < 0)
+        {
+          ::close(fd);
+
+          return false;
+        }
+        if (S_ISREG(st.st_mode) && st.st_size >= PLORTH_FILE_MAP_THRESHOLD)
+        {
+          void* data = ::mmap(
+            nullptr,
+            static_cast<std::size_t>(st.st_size),
+            PROT_READ,
+            MAP_PRIVATE,
+            fd,
+            0
+          );
+
+          ::close(fd);
+          if (data == MAP_FAILED)
+          {
+            return false;
+          }
+#if defined(MADV_SEQUENTIAL)
+          ::madvise(
+            data,
+            static_cast<std::size_t>(st.st_size),
+            MADV_SEQUENTIAL
+          );
+#endif
+          m_data = static_cast<const unsigned char*>(data);
+          m_size = static_cast<std::size_t>(st.st_size);
+          m_mapped = true;
+
+          return true;
+        }
+        ::close(fd);
+#endif
+        std::ifstream is(path, std::ios_base::in | std::ios_base::binary);
+
+        if (!is.good())
+        {
+          return false;
+        }
+        m_buffer.assign(
+          std::istreambuf_iterator<char>(is),
+          std::istreambuf_iterator<char>()
+        );
+        m_data = reinterpret_cast<const unsigned char*>(m_buffer.data());
+        m_size = m_buffer.length();
+
+        return true;
+      }
+
+      inline const unsigned char* data() const
+      {
+        return m_data;
+      }
+
+      inline std::size_t size() const
+      {
+        return m_size;
+      }
+
+    private:
+      const unsigned char* m_data;
+      std::size_t m_size;
+      bool m_mapped;
+      std::string m_buffer;
+    };
+
+    /**
+     * Implementation of string which references UTF-8 encoded contents of a
+     * file without decoding them. Characters are decoded when they are
+     * accessed, with help of an index which contains byte offset of every
+     * stride:th character. Pure ASCII strings need no index, as each byte is
+     * a character of it's own.
+     */
+    class encoded_string : public string
+    {
+    public:
+      static const size_type stride = 16;
+
+      explicit encoded_string(const std::shared_ptr<file_contents>& contents,
+                              const unsigned char* bytes,
+                              size_type byte_length,
+                              size_type length,
+                              bool ascii,
+                              std::vector<size_type>&& index)
+        : m_contents(contents)
+        , m_bytes(bytes)
+        , m_byte_length(byte_length)
+        , m_length(length)
+        , m_ascii(ascii)
+        , m_index(std::move(index)) {}
+
+      inline size_type length() const
+      {
+        return m_length;
+      }
+
+      value_type at(size_type offset) const
+      {
+        if (m_ascii)
+        {
+          return m_bytes[offset];
+        }
+
+        return decode(locate(offset));
+      }
+
+      void copy(pointer output, size_type offset, size_type count) const
+      {
+        const unsigned char* p;
+
+        if (m_ascii)
+        {
+          std::copy(m_bytes + offset, m_bytes + offset + count, output);
+          return;
+        }
+        for (p = locate(offset); count > 0; --count)
+        {
+          *output++ = decode(p);
+          p += utf8_sequence_length(*p);
+        }
+      }
+
+      inline const unsigned char* bytes() const
+      {
+        return m_bytes;
+      }
+
+      inline size_type byte_length() const
+      {
+        return m_byte_length;
+      }
+
+    private:
+      /**
+       * Returns pointer to the first byte of character at given offset.
+       */
+      const unsigned char* locate(size_type offset) const
+      {
+        const auto block = offset / stride;
+        auto p = m_bytes + (block > 0 ? m_index[block - 1] : 0);
+
+        for (offset -= block * stride; offset > 0; --offset)
+        {
+          p += utf8_sequence_length(*p);
+        }
+
+        return p;
+      }
+
+      /**
+       * Decodes single UTF-8 encoded character.
+       */
+      static value_type decode(const unsigned char* p)
+      {
+        const auto length = utf8_sequence_length(*p);
+        value_type c;
+
+        switch (length)
+        {
+          case 1:
+            return *p;
+
+          case 2:
+            c = *p & 0x1f;
+            break;
+
+          case 3:
+            c = *p & 0x0f;
+            break;
+
+          default:
+            c = *p & 0x07;
+            break;
+        }
+        for (std::size_t i = 1; i < length; ++i)
+        {
+          c = (c << 6) | (p[i] & 0x3f);
+        }
+
+        return c;
+      }
+
+      /** Keeps the referenced file contents alive. */
+      const std::shared_ptr<file_contents> m_contents;
+      /** Pointer to the UTF-8 encoded characters. */
+      const unsigned char* m_bytes;
+      /** Number of bytes in the string. */
+      const size_type m_byte_length;
+      /** Number of characters in the string. */
+      const size_type m_length;
+      /** Whether the string consists only of ASCII characters. */
+      const bool m_ascii;
+      /** Byte offsets of every stride:th character, excluding the first. */
+      const std::vector<size_type> m_index;
+    };
+
+    /**
+     * Reader state shared by the methods of a file object.
+     */
+    struct file_reader
+    {
+      std::shared_ptr<file_contents> contents;
+      std::size_t offset;
+    };
+
+    static inline bool is_ascii_word(const unsigned char* p)
+    {
+      std::uint64_t word;
+
+      std::memcpy(&word, p, sizeof(word));
+
+      return !(word & UINT64_C(0x8080808080808080));
+    }
+  }
+
+  /**
+   * Validates UTF-8 encoded range of file contents and constructs a string
+   * which references it.
+   */
+  static std::shared_ptr<string> make_encoded_string(
+    const std::shared_ptr<runtime>& runtime,
+    const std::shared_ptr<file_contents>& contents,
+    const unsigned char* begin,
+    const unsigned char* end
+  )
+  {
+    const auto stride = encoded_string::stride;
+    std::vector<string::size_type> index;
+    string::size_type length = 0;
+    bool ascii = true;
+    auto p = begin;
+
+    while (p < end)
+    {
+      std::size_t sequence_length;
+
+      // Skip runs of ASCII characters quickly.
+      if (ascii)
+      {
+        while (end - p >= 8 && is_ascii_word(p))
+        {
+          p += 8;
+          length += 8;
+        }
+        if (p >= end)
+        {
+          break;
+        }
+      }
+
+      if (!(sequence_length = utf8_sequence_length(*p))
+          || sequence_length > 4
+          || static_cast<std::size_t>(end - p) < sequence_length)
+      {
+        return std::shared_ptr<string>();
+      }
+      for (std::size_t i = 1; i < sequence_length; ++i)
+      {
+        if ((p[i] & 0xc0) != 0x80)
+        {
+          return std::shared_ptr<string>();
+        }
+      }
+
+      // First non-ASCII character was encountered, so the preceding
+      // characters need to be indexed as well.
+      if (ascii && sequence_length > 1)
+      {
+        ascii = false;
+        for (string::size_type i = stride; i < length; i += stride)
+        {
+          index.push_back(i);
+        }
+      }
+      if (!ascii && length > 0 && !(length % stride))
+      {
+        index.push_back(p - begin);
+      }
+      p += sequence_length;
+      ++length;
+    }
+
+    return runtime->value<encoded_string>(
+      contents,
+      begin,
+      end - begin,
+      length,
+      ascii,
+      std::move(index)
+    );
+  }
+
+  static std::shared_ptr<file_contents> load_file(
+    const std::shared_ptr<context>& ctx,
+    const std::u32string& path
+  )
+  {
+    auto contents = std::make_shared<file_contents>();
+
+    if (!contents->load(utf8_encode(path)))
+    {
+      ctx->error(
+        error::code::io,
+        U"Unable to open file `" + path + U"' for reading."
+      );
+      contents.reset();
+    }
+
+    return contents;
+  }
+
+  /**
+   * Constructs string from single line of file contents, removing trailing
+   * carriage return.
+   */
+  static std::shared_ptr<string> make_line(
+    const std::shared_ptr<context>& ctx,
+    const std::shared_ptr<file_contents>& contents,
+    const unsigned char* begin,
+    const unsigned char* end
+  )
+  {
+    std::shared_ptr<string> line;
+
+    if (end > begin && end[-1] == '\r')
+    {
+      --end;
+    }
+    if (!(line = make_encoded_string(ctx->runtime(), contents, begin, end)))
+    {
+      ctx->error(error::code::io, U"Unable to decode file as UTF-8.");
+    }
+
+    return line;
+  }
+
+  namespace io
+  {
+    std::shared_ptr<string> read_file(const std::shared_ptr<context>& ctx,
+                                      const std::u32string& path)
+    {
+      const auto contents = load_file(ctx, path);
+      std::shared_ptr<string> result;
+
+      if (!contents)
+      {
+        return result;
+      }
+      if (!(result = make_encoded_string(
+        ctx->runtime(),
+        contents,
+        contents->data(),
+        contents->data() + contents->size()
+      )))
+      {
+        ctx->error(error::code::io, U"Unable to decode file as UTF-8.");
+      }
+
+      return result;
+    }
+
+    bool read_lines(const std::shared_ptr<context>& ctx,
+                    const std::u32string& path,
+                    std::vector<std::shared_ptr<value>>& lines)
+    {
+      const auto contents = load_file(ctx, path);
+      const unsigned char* begin;
+      const unsigned char* end;
+
+      if (!contents)
+      {
+        return false;
+      }
+      begin = contents->data();
+      end = begin + contents->size();
+      while (begin < end)
+      {
+        auto newline = static_cast<const unsigned char*>(
+          std::memchr(begin, '\n', end - begin)
+        );
+        std::shared_ptr<string> line;
+
+        if (!newline)
+        {
+          newline = end;
+        }
+        if (!(line = make_line(ctx, contents, begin, newline)))
+        {
+          return false;
+        }
+        lines.push_back(line);
+        begin = newline + 1;
+      }
+
+      return true;
+    }
+
+    bool write_file(const std::shared_ptr<context>& ctx,
+                    const std::u32string& path,
+                    const std::shared_ptr<string>& contents)
+    {
+      std::ofstream os(
+        utf8_encode(path),
+        std::ios_base::out | std::ios_base::binary | std::ios_base::trunc
+      );
+
+      if (os.good())
+      {
+        // Strings read from files can be written without encoding them
+        // again.
+        if (const auto encoded = dynamic_cast<const encoded_string*>(
+          contents.get()
+        ))
+        {
+          os.write(
+            reinterpret_cast<const char*>(encoded->bytes()),
+            encoded->byte_length()
+          );
+        } else {
+          const auto bytes = utf8_encode(contents->to_string());
+
+          os.write(bytes.data(), bytes.length());
+        }
+        os.close();
+        if (os.good())
+        {
+          return true;
+        }
+      }
+      ctx->error(
+        error::code::io,
+        U"Unable to open file `" + path + U"' for writing."
+      );
+
+      return false;
+    }
+
+    std::shared_ptr<object> open_file(const std::shared_ptr<context>& ctx,
+                                      const std::u32string& path)
+    {
+      const auto& runtime = ctx->runtime();
+      auto reader = std::make_shared<file_reader>();
+
+      if (!(reader->contents = load_file(ctx, path)))
+      {
+        return std::shared_ptr<object>();
+      }
+      reader->offset = 0;
+
+      return runtime->object({
+        {
+          U"__proto__",
+          runtime->object({
+            { U"__proto__", runtime->object_prototype() },
+            {
+              U"read-line",
+              runtime->native_quote([reader](
+                const std::shared_ptr<context>& ctx
+              )
+              {
+                const unsigned char* begin;
+                const unsigned char* end;
+                const unsigned char* newline;
+                std::shared_ptr<string> line;
+
+                if (!reader->contents
+                    || reader->offset >= reader->contents->size())
+                {
+                  ctx->push_null();
+
+                  return;
+                }
+                begin = reader->contents->data() + reader->offset;
+                end = reader->contents->data() + reader->contents->size();
+                if (!(newline = static_cast<const unsigned char*>(
+                  std::memchr(begin, '\n', end - begin)
+                )))
+                {
+                  newline = end;
+                }
+                if ((line = make_line(ctx, reader->contents, begin, newline)))
+                {
+                  reader->offset += newline - begin + 1;
+                  ctx->push(line);
+                }
+              })
+            },
+            {
+              U"close",
+              runtime->native_quote([reader](
+                const std::shared_ptr<context>& ctx
+              )
+              {
+                std::shared_ptr<value> file;
+
+                if (ctx->pop(file, value::type::object))
+                {
+                  reader->contents.reset();
+                }
+              })
+            }
+          })
+        },
+        { U"path", runtime->string(path) }
+      });
+    }
+
+    bool encoded_bytes(const std::shared_ptr<string>& str,
+                       const unsigned char*& bytes,
+                       std::size_t& length)
+    {
+      const auto encoded = dynamic_cast<const encoded_string*>(str.get());
+
+      if (!encoded)
+      {
+        return false;
+      }
+      bytes = encoded->bytes();
+      length = encoded->byte_length();
+
+      return true;
+    }
+  }
+}
+#endif
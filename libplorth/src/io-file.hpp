@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2017-2018, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PLORTH_IO_FILE_HPP_GUARD
+#define PLORTH_IO_FILE_HPP_GUARD
+
+#include <plorth/context.hpp>
+
+namespace plorth
+{
+  namespace io
+  {
+    /**
+     * Reads contents of a file into a string. Contents of the file are
+     * decoded lazily, when characters of the string are accessed, and large
+     * files are mapped into memory instead of being read.
+     *
+     * \param ctx  Execution context used for error reporting.
+     * \param path Path of the file to read.
+     * \return     The string, or null reference if the file could not be
+     *             read or is not valid UTF-8.
+     */
+    std::shared_ptr<string> read_file(const std::shared_ptr<context>& ctx,
+                                      const std::u32string& path);
+
+    /**
+     * Reads contents of a file as lines. The lines share contents of the file
+     * instead of being copied.
+     *
+     * \param ctx   Execution context used for error reporting.
+     * \param path  Path of the file to read.
+     * \param lines Where the lines are placed into.
+     * \return      Boolean flag telling whether the operation was successful
+     *              or not.
+     */
+    bool read_lines(const std::shared_ptr<context>& ctx,
+                    const std::u32string& path,
+                    std::vector<std::shared_ptr<value>>& lines);
+
+    /**
+     * Writes given string into a file encoded in UTF-8, replacing previous
+     * contents of the file.
+     *
+     * \param ctx      Execution context used for error reporting.
+     * \param path     Path of the file to write into.
+     * \param contents String to write.
+     * \return         Boolean flag telling whether the operation was
+     *                 successful or not.
+     */
+    bool write_file(const std::shared_ptr<context>& ctx,
+                    const std::u32string& path,
+                    const std::shared_ptr<string>& contents);
+
+    /**
+     * Opens a file for reading it line by line. Returns an object whose
+     * prototype has `read-line` and `close` methods.
+     *
+     * \param ctx  Execution context used for error reporting.
+     * \param path Path of the file to open.
+     * \return     The file object, or null reference if the file could not be
+     *             opened.
+     */
+    std::shared_ptr<object> open_file(const std::shared_ptr<context>& ctx,
+                                      const std::u32string& path);
+
+    /**
+     * Retrieves the UTF-8 encoded bytes of a string which has been read from
+     * a file, allowing them to be processed without decoding the string.
+     *
+     * \param str    String to retrieve bytes of.
+     * \param bytes  Where pointer to the bytes is stored into.
+     * \param length Where number of the bytes is stored into.
+     * \return       Boolean flag telling whether the string was read from a
+     *               file or not.
+     */
+    bool encoded_bytes(const std::shared_ptr<string>& str,
+                       const unsigned char*& bytes,
+                       std::size_t& length);
+  }
+}
+
+#endif /* !PLORTH_IO_FILE_HPP_GUARD */
@@ -24,59 +24,277 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 #include <plorth/io-input.hpp>
+#include <plorth/scheduler.hpp>
+
+#include <cstring>
+
+#if HAVE_UNISTD_H
+# include <cerrno>
+# include <unistd.h>
+#endif
+#if HAVE_POLL_H
+# include <poll.h>
+#endif
 
 namespace plorth
 {
   namespace
   {
+    /**
+     * Decodes UTF-8 encoded input given byte by byte by the callback, which
+     * returns negative value once there is no more input available.
+     */
+    template<class Callback>
+    io::input::result read_utf8(Callback get,
+                                io::input::size_type size,
+                                std::u32string& output,
+                                io::input::size_type& read)
+    {
+      const bool infinite = !size;
+      char buffer[6];
+
+      read = 0;
+      while (infinite || size > 0)
+      {
+        auto byte = get();
+        std::size_t unicode_size;
+
+        if (byte < 0)
+        {
+          return io::input::result::eof;
+        }
+        else if (!(unicode_size = utf8_sequence_length(byte)))
+        {
+          return io::input::result::failure;
+        }
+        buffer[0] = static_cast<char>(byte);
+        for (std::size_t i = 1; i < unicode_size; ++i)
+        {
+          if ((byte = get()) < 0)
+          {
+            return io::input::result::failure;
+          }
+          buffer[i] = static_cast<char>(byte);
+        }
+        if (!utf8_decode_test(buffer, unicode_size, output))
+        {
+          return io::input::result::failure;
+        }
+        if (!infinite)
+        {
+          --size;
+        }
+        ++read;
+      }
+
+      return io::input::result::ok;
+    }
+
 #if PLORTH_ENABLE_STANDARD_IO
     class standard_input : public io::input
     {
     public:
       result read(size_type size, std::u32string& output, size_type& read)
       {
+#if PLORTH_ENABLE_GREEN_THREADS && HAVE_UNISTD_H
+        // Let other tasks run until there is something to read. Input
+        // buffered by C standard I/O is not visible here, so this is only a
+        // best effort.
+        if (std::cin.rdbuf()->in_avail() <= 0)
+        {
+          scheduler::current().wait_readable(STDIN_FILENO);
+        }
+#endif
+
+        // When reading everything, read the input in chunks and decode it
+        // all at once.
+        if (!size)
+        {
+          const auto offset = output.length();
+          std::string input;
+          char chunk[4096];
+          std::streamsize chunk_size;
+          bool valid;
+
+          for (;;)
+          {
+            chunk_size = std::cin.rdbuf()->sgetn(chunk, sizeof(chunk));
+            if (chunk_size <= 0)
+            {
+              break;
+            }
+            input.append(chunk, chunk_size);
+          }
+          valid = utf8_decode_test(input, output);
+          read = output.length() - offset;
+
+          return valid ? result::eof : result::failure;
+        }
+
+        return read_utf8([]()
+        {
+          const auto byte = std::cin.get();
+
+          return byte == std::char_traits<char>::eof() ? -1 : byte;
+        }, size, output, read);
+      }
+    };
+#endif
+
+#if HAVE_UNISTD_H
+    /**
+     * Waits until given file descriptor becomes readable, giving control to
+     * other green threads in the meantime, if there are any.
+     */
+    static bool wait_readable(int fd)
+    {
+#if PLORTH_ENABLE_GREEN_THREADS
+      if (scheduler::current().wait_readable(fd))
+      {
+        return true;
+      }
+#endif
+#if HAVE_POLL_H
+      struct pollfd descriptor;
+
+      descriptor.fd = fd;
+      descriptor.events = POLLIN;
+      descriptor.revents = 0;
+
+      return ::poll(&descriptor, 1, -1) >= 0 || errno == EINTR;
+#else
+      return false;
+#endif
+    }
+
+    class descriptor_input : public io::input
+    {
+    public:
+      explicit descriptor_input(int fd)
+        : m_fd(fd)
+        , m_offset(0)
+        , m_length(0) {}
+
+      result read(size_type size, std::u32string& output, size_type& read)
+      {
         const bool infinite = !size;
-        const auto eof = std::char_traits<char>::eof();
-        std::string buffer;
 
-        buffer.reserve(6);
         read = 0;
-        while (infinite || size > 0)
+        while (infinite || read < size)
         {
-          auto byte = std::cin.get();
-          std::size_t unicode_size;
+          std::size_t end;
+          std::size_t sequence_length;
 
-          if (byte == eof)
+          if (m_offset >= m_length && !fill())
           {
             return result::eof;
           }
-          else if (!(unicode_size = utf8_sequence_length(byte)))
+
+          // Decode runs of ASCII characters directly from the buffer.
+          end = m_offset;
+          while (end < m_length
+                 && (infinite || read + (end - m_offset) < size)
+                 && !(m_buffer[end] & 0x80))
+          {
+            ++end;
+          }
+          if (end > m_offset)
+          {
+            output.append(m_buffer + m_offset, m_buffer + end);
+            read += end - m_offset;
+            m_offset = end;
+            continue;
+          }
+
+          // Multi-byte sequences may be split between two reads.
+          if (!(sequence_length = utf8_sequence_length(m_buffer[m_offset])))
           {
             return result::failure;
           }
-          buffer.clear();
-          buffer.append(1, byte);
-          for (std::size_t i = 1; i < unicode_size; ++i)
+          while (m_length - m_offset < sequence_length)
           {
-            if ((byte = std::cin.get()) == eof)
+            if (!fill())
             {
               return result::failure;
             }
-            buffer.append(1, byte);
           }
-          if (!utf8_decode_test(buffer, output))
+          if (!utf8_decode_test(
+            std::string(
+              m_buffer + m_offset,
+              m_buffer + m_offset + sequence_length
+            ),
+            output
+          ))
           {
             return result::failure;
           }
-          if (!infinite)
-          {
-            --size;
-          }
+          m_offset += sequence_length;
           ++read;
         }
 
         return result::ok;
       }
+
+    private:
+      /**
+       * Reads more data from the file descriptor into the buffer, keeping the
+       * data which has not been consumed yet. Returns false on end of input
+       * or error.
+       */
+      bool fill()
+      {
+        if (m_offset > 0)
+        {
+          std::memmove(m_buffer, m_buffer + m_offset, m_length - m_offset);
+          m_length -= m_offset;
+          m_offset = 0;
+        }
+        for (;;)
+        {
+          ssize_t result;
+
+#if PLORTH_ENABLE_GREEN_THREADS
+          scheduler::current().wait_readable(m_fd);
+#endif
+          result = ::read(
+            m_fd,
+            m_buffer + m_length,
+            sizeof(m_buffer) - m_length
+          );
+
+          if (result > 0)
+          {
+            m_length += static_cast<std::size_t>(result);
+
+            return true;
+          }
+          else if (!result)
+          {
+            return false;
+          }
+          else if (errno == EAGAIN || errno == EWOULDBLOCK)
+          {
+            if (!wait_readable(m_fd))
+            {
+              return false;
+            }
+          }
+          else if (errno != EINTR)
+          {
+            return false;
+          }
+        }
+      }
+
+    private:
+      /** File descriptor to read from. */
+      const int m_fd;
+      /** Buffer for data read from the file descriptor. */
+      unsigned char m_buffer[4096];
+      /** Position of next byte to be decoded from the buffer. */
+      std::size_t m_offset;
+      /** Number of bytes in the buffer. */
+      std::size_t m_length;
     };
 #endif
 
@@ -103,6 +321,18 @@ namespace plorth
 #endif
     }
 
+    std::shared_ptr<input> input::file_descriptor(
+      memory::manager& memory_manager,
+      int fd
+    )
+    {
+#if HAVE_UNISTD_H
+      return std::shared_ptr<input>(new (memory_manager) descriptor_input(fd));
+#else
+      return dummy(memory_manager);
+#endif
+    }
+
     std::shared_ptr<input> input::dummy(memory::manager& memory_manager)
     {
       return std::shared_ptr<input>(new (memory_manager) dummy_input());
@@ -24,6 +24,21 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 #include <plorth/io-output.hpp>
+#include <plorth/scheduler.hpp>
+
+#if HAVE_UNISTD_H
+# include <cerrno>
+# include <unistd.h>
+#endif
+#if HAVE_POLL_H
+# include <poll.h>
+#endif
+#if HAVE_SYS_SOCKET_H
+# include <sys/socket.h>
+#endif
+#if HAVE_SIGNAL_H
+# include <signal.h>
+#endif
 
 namespace plorth
 {
@@ -52,6 +67,168 @@ namespace plorth
       }
     };
 #endif
+
+#if HAVE_UNISTD_H
+    /**
+     * Waits until given file descriptor becomes writable, giving control to
+     * other green threads in the meantime, if there are any.
+     */
+    static bool wait_writable(int fd)
+    {
+#if PLORTH_ENABLE_GREEN_THREADS
+      if (scheduler::current().wait_writable(fd))
+      {
+        return true;
+      }
+#endif
+#if HAVE_POLL_H
+      struct pollfd descriptor;
+
+      descriptor.fd = fd;
+      descriptor.events = POLLOUT;
+      descriptor.revents = 0;
+
+      return ::poll(&descriptor, 1, -1) >= 0 || errno == EINTR;
+#else
+      return false;
+#endif
+    }
+
+    class descriptor_output : public io::output
+    {
+    public:
+      explicit descriptor_output(int fd)
+        : m_fd(fd)
+#if HAVE_SYS_SOCKET_H && defined(MSG_NOSIGNAL)
+        , m_socket(true)
+#endif
+      {
+#if HAVE_SYS_SOCKET_H && defined(SO_NOSIGPIPE)
+        // Platforms without MSG_NOSIGNAL suppress SIGPIPE per socket. For
+        // other types of file descriptors this fails, which is harmless.
+        int value = 1;
+
+        ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &value, sizeof(value));
+#endif
+      }
+
+      void write(const std::u32string& str)
+      {
+        const auto bytes = utf8_encode(str);
+        const char* data = bytes.c_str();
+        std::size_t remaining = bytes.length();
+
+        while (remaining > 0)
+        {
+          const auto result = write_some(data, remaining);
+
+          if (result > 0)
+          {
+            data += result;
+            remaining -= static_cast<std::size_t>(result);
+          }
+          else if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+          {
+            if (!wait_writable(m_fd))
+            {
+              return;
+            }
+          }
+          else if (result < 0 && errno != EINTR)
+          {
+            // There is no way to report the error, so rest of the output is
+            // discarded.
+            return;
+          }
+        }
+      }
+
+    private:
+      /**
+       * Writes as much of given data into the file descriptor as possible.
+       * Writing into a socket or pipe closed by the peer gives an error
+       * instead of raising SIGPIPE which would terminate the whole process.
+       * Sockets are written with send(), while for other file descriptors
+       * SIGPIPE is blocked for the duration of the write.
+       */
+      ::ssize_t write_some(const char* data, std::size_t length)
+      {
+#if HAVE_SYS_SOCKET_H && defined(MSG_NOSIGNAL)
+        if (m_socket)
+        {
+          const auto result = ::send(m_fd, data, length, MSG_NOSIGNAL);
+
+          if (result >= 0 || errno != ENOTSOCK)
+          {
+            return result;
+          }
+          m_socket = false;
+        }
+#endif
+#if HAVE_SIGNAL_H && defined(SIGPIPE)
+        ::sigset_t pipe_set;
+        ::sigset_t old_set;
+        ::sigset_t pending_set;
+        ::ssize_t result;
+        int error;
+        bool pending;
+
+        sigemptyset(&pipe_set);
+        sigaddset(&pipe_set, SIGPIPE);
+        ::sigpending(&pending_set);
+        pending = sigismember(&pending_set, SIGPIPE);
+        block_signals(SIG_BLOCK, &pipe_set, &old_set);
+
+        result = ::write(m_fd, data, length);
+        error = errno;
+
+        // Consume the SIGPIPE raised by the write, unless one was already
+        // pending before it, so that it isn't delivered once the signal is
+        // unblocked.
+        if (result < 0 && error == EPIPE && !pending)
+        {
+          ::sigpending(&pending_set);
+          if (sigismember(&pending_set, SIGPIPE))
+          {
+            int signal;
+
+            ::sigwait(&pipe_set, &signal);
+          }
+        }
+        block_signals(SIG_SETMASK, &old_set, nullptr);
+        errno = error;
+
+        return result;
+#else
+        return ::write(m_fd, data, length);
+#endif
+      }
+
+#if HAVE_SIGNAL_H && defined(SIGPIPE)
+      /**
+       * Changes the signal mask of the calling thread.
+       */
+      static void block_signals(int how,
+                                const ::sigset_t* set,
+                                ::sigset_t* old_set)
+      {
+#if PLORTH_ENABLE_THREADS
+        ::pthread_sigmask(how, set, old_set);
+#else
+        ::sigprocmask(how, set, old_set);
+#endif
+      }
+#endif
+
+    private:
+      /** File descriptor to write into. */
+      const int m_fd;
+#if HAVE_SYS_SOCKET_H && defined(MSG_NOSIGNAL)
+      /** Whether the file descriptor is still assumed to be a socket. */
+      bool m_socket;
+#endif
+    };
+#endif
   }
 
   namespace io
@@ -65,6 +242,18 @@ namespace plorth
 #endif
     }
 
+    std::shared_ptr<output> output::file_descriptor(
+      memory::manager& memory_manager,
+      int fd
+    )
+    {
+#if HAVE_UNISTD_H
+      return std::shared_ptr<output>(new (memory_manager) descriptor_output(fd));
+#else
+      return dummy(memory_manager);
+#endif
+    }
+
     std::shared_ptr<output> output::dummy(memory::manager& memory_manager)
     {
       return std::shared_ptr<output>(new (memory_manager) dummy_output());
@@ -0,0 +1,819 @@
+/*
+ * Copyright (c) 2017-2018, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <plorth/context.hpp>
+#include <plorth/unicode.hpp>
+
+#include "./io-file.hpp"
+#include "./json.hpp"
+#include "./utils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#if defined(__SSE2__)
+# include <emmintrin.h>
+#endif
+
+#if !defined(PLORTH_JSON_MAX_DEPTH)
+# define PLORTH_JSON_MAX_DEPTH 512
+#endif
+
+namespace plorth
+{
+  namespace json
+  {
+    namespace
+    {
+#if defined(__SSE2__)
+      static inline unsigned int count_trailing_zeros(unsigned int mask)
+      {
+# if defined(__GNUC__)
+        return __builtin_ctz(mask);
+# else
+        unsigned int count = 0;
+
+        while (!(mask & 1))
+        {
+          mask >>= 1;
+          ++count;
+        }
+
+        return count;
+# endif
+      }
+#endif
+
+      /**
+       * Returns pointer to the first byte in given range which cannot be
+       * copied into a string as it is: quotation mark, backslash, control
+       * character or first byte of multibyte UTF-8 sequence. Sixteen bytes
+       * are inspected at once when SSE2 instructions are available.
+       */
+      static inline const unsigned char* scan_string(const unsigned char* p,
+                                                     const unsigned char* end)
+      {
+#if defined(__SSE2__)
+        const auto quote = _mm_set1_epi8('"');
+        const auto backslash = _mm_set1_epi8('\\');
+        const auto space = _mm_set1_epi8(' ');
+
+        while (end - p >= 16)
+        {
+          const auto chunk = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(p)
+          );
+          // Signed comparison catches both control characters and bytes which
+          // have their highest bit set.
+          const auto mask = _mm_movemask_epi8(
+            _mm_or_si128(
+              _mm_or_si128(
+                _mm_cmpeq_epi8(chunk, quote),
+                _mm_cmpeq_epi8(chunk, backslash)
+              ),
+              _mm_cmplt_epi8(chunk, space)
+            )
+          );
+
+          if (mask)
+          {
+            return p + count_trailing_zeros(mask);
+          }
+          p += 16;
+        }
+#endif
+        while (p < end && *p != '"' && *p != '\\' && *p >= 0x20 && *p < 0x80)
+        {
+          ++p;
+        }
+
+        return p;
+      }
+
+      /**
+       * Decodes single UTF-8 encoded character and appends it into given
+       * string.
+       */
+      static bool append_char(const unsigned char*& p,
+                              const unsigned char* end,
+                              std::u32string& output)
+      {
+        const auto length = utf8_sequence_length(*p);
+        char32_t c;
+
+        if (length < 2 || length > 4 || end - p < static_cast<long>(length))
+        {
+          return false;
+        }
+        c = *p & (0xff >> (length + 1));
+        for (std::size_t i = 1; i < length; ++i)
+        {
+          if ((p[i] & 0xc0) != 0x80)
+          {
+            return false;
+          }
+          c = (c << 6) | (p[i] & 0x3f);
+        }
+        p += length;
+        output.append(1, c);
+
+        return true;
+      }
+
+      static inline bool is_digit(char32_t c)
+      {
+        return c >= '0' && c <= '9';
+      }
+
+      static inline int hex_digit(char32_t c)
+      {
+        if (c >= '0' && c <= '9')
+        {
+          return c - '0';
+        }
+        else if (c >= 'a' && c <= 'f')
+        {
+          return c - 'a' + 10;
+        }
+        else if (c >= 'A' && c <= 'F')
+        {
+          return c - 'A' + 10;
+        }
+
+        return -1;
+      }
+
+      /**
+       * Recursive descent parser which constructs values directly from UTF-8
+       * encoded JSON input.
+       */
+      class parser
+      {
+      public:
+        explicit parser(const std::shared_ptr<context>& ctx,
+                        const unsigned char* begin,
+                        const unsigned char* end)
+          : m_context(ctx)
+          , m_runtime(ctx->runtime())
+          , m_current(begin)
+          , m_end(end)
+          , m_depth(0) {}
+
+        bool parse(std::shared_ptr<value>& slot)
+        {
+          if (!parse_value(slot))
+          {
+            return false;
+          }
+          skip_whitespace();
+          if (m_current < m_end)
+          {
+            return unexpected();
+          }
+
+          return true;
+        }
+
+      private:
+        inline void skip_whitespace()
+        {
+          while (m_current < m_end && (*m_current == ' '
+                                       || *m_current == '\n'
+                                       || *m_current == '\r'
+                                       || *m_current == '\t'))
+          {
+            ++m_current;
+          }
+        }
+
+        bool unexpected()
+        {
+          m_context->error(
+            error::code::value,
+            m_current < m_end
+              ? U"Unexpected character in JSON input."
+              : U"Unexpected end of JSON input."
+          );
+
+          return false;
+        }
+
+        bool unpaired_surrogate()
+        {
+          m_context->error(
+            error::code::value,
+            U"Unpaired surrogate in JSON input."
+          );
+
+          return false;
+        }
+
+        bool parse_value(std::shared_ptr<value>& slot)
+        {
+          skip_whitespace();
+          if (m_current >= m_end)
+          {
+            return unexpected();
+          }
+          switch (*m_current)
+          {
+            case '{':
+              return parse_object(slot);
+
+            case '[':
+              return parse_array(slot);
+
+            case '"':
+              if (!parse_string(m_buffer))
+              {
+                return false;
+              }
+              slot = m_runtime->string(m_buffer);
+
+              return true;
+
+            case 't':
+              return parse_literal("true", m_runtime->true_value(), slot);
+
+            case 'f':
+              return parse_literal("false", m_runtime->false_value(), slot);
+
+            case 'n':
+              return parse_literal("null", std::shared_ptr<value>(), slot);
+
+            default:
+              if (*m_current == '-' || is_digit(*m_current))
+              {
+                return parse_number(slot);
+              }
+
+              return unexpected();
+          }
+        }
+
+        bool parse_literal(const char* literal,
+                           const std::shared_ptr<value>& result,
+                           std::shared_ptr<value>& slot)
+        {
+          for (; *literal; ++literal, ++m_current)
+          {
+            if (m_current >= m_end || *m_current != *literal)
+            {
+              return unexpected();
+            }
+          }
+          slot = result;
+
+          return true;
+        }
+
+        bool parse_number(std::shared_ptr<value>& slot)
+        {
+          const auto start = m_current;
+          std::uint64_t magnitude = 0;
+          bool negative = false;
+          bool integer = true;
+
+          if (*m_current == '-')
+          {
+            negative = true;
+            ++m_current;
+          }
+          if (m_current >= m_end || !is_digit(*m_current))
+          {
+            return unexpected();
+          }
+          if (*m_current == '0')
+          {
+            ++m_current;
+          } else {
+            do
+            {
+              if (magnitude > (UINT64_MAX - 9) / 10)
+              {
+                integer = false;
+              }
+              magnitude = magnitude * 10 + (*m_current++ - '0');
+            }
+            while (m_current < m_end && is_digit(*m_current));
+          }
+          if (m_current < m_end && *m_current == '.')
+          {
+            integer = false;
+            if (++m_current >= m_end || !is_digit(*m_current))
+            {
+              return unexpected();
+            }
+            while (m_current < m_end && is_digit(*m_current))
+            {
+              ++m_current;
+            }
+          }
+          if (m_current < m_end && (*m_current == 'e' || *m_current == 'E'))
+          {
+            integer = false;
+            if (++m_current < m_end && (*m_current == '+' || *m_current == '-'))
+            {
+              ++m_current;
+            }
+            if (m_current >= m_end || !is_digit(*m_current))
+            {
+              return unexpected();
+            }
+            while (m_current < m_end && is_digit(*m_current))
+            {
+              ++m_current;
+            }
+          }
+
+          // Integers which fit into the integer type are converted directly,
+          // everything else is converted with correct rounding by strtod().
+          if (integer && magnitude <= static_cast<std::uint64_t>(
+            number::int_max
+          ) + negative)
+          {
+            slot = m_runtime->number(
+              negative
+                ? -static_cast<number::int_type>(magnitude - 1) - 1
+                : static_cast<number::int_type>(magnitude)
+            );
+          } else {
+            double real;
+
+            m_number.assign(start, m_current);
+            real = std::strtod(m_number.c_str(), nullptr);
+
+            // JSON has no representation for infinite numbers, so they would
+            // not survive the round trip back to JSON.
+            if (!std::isfinite(real))
+            {
+              m_context->error(
+                error::code::value,
+                U"Number in JSON input is out of range."
+              );
+
+              return false;
+            }
+            slot = m_runtime->number(real);
+          }
+
+          return true;
+        }
+
+        bool parse_string(std::u32string& output)
+        {
+          output.clear();
+          ++m_current;
+          for (;;)
+          {
+            const auto run = scan_string(m_current, m_end);
+
+            output.append(m_current, run);
+            m_current = run;
+            if (m_current >= m_end)
+            {
+              return unexpected();
+            }
+            else if (*m_current == '"')
+            {
+              ++m_current;
+
+              return true;
+            }
+            else if (*m_current == '\\')
+            {
+              if (!parse_escape_sequence(output))
+              {
+                return false;
+              }
+            }
+            else if (*m_current < 0x20)
+            {
+              return unexpected();
+            }
+            else if (!append_char(m_current, m_end, output))
+            {
+              m_context->error(
+                error::code::value,
+                U"Unable to decode JSON input as UTF-8."
+              );
+
+              return false;
+            }
+          }
+        }
+
+        bool parse_hex(char32_t& result)
+        {
+          result = 0;
+          for (int i = 0; i < 4; ++i)
+          {
+            int digit;
+
+            if (m_current >= m_end || (digit = hex_digit(*m_current)) < 0)
+            {
+              return unexpected();
+            }
+            result = (result << 4) | digit;
+            ++m_current;
+          }
+
+          return true;
+        }
+
+        bool parse_escape_sequence(std::u32string& output)
+        {
+          char32_t c;
+
+          if (++m_current >= m_end)
+          {
+            return unexpected();
+          }
+          switch (*m_current++)
+          {
+            case '"':
+              c = '"';
+              break;
+
+            case '\\':
+              c = '\\';
+              break;
+
+            case '/':
+              c = '/';
+              break;
+
+            case 'b':
+              c = 010;
+              break;
+
+            case 'f':
+              c = 014;
+              break;
+
+            case 'n':
+              c = 012;
+              break;
+
+            case 'r':
+              c = 015;
+              break;
+
+            case 't':
+              c = 011;
+              break;
+
+            case 'u':
+              if (!parse_hex(c))
+              {
+                return false;
+              }
+              else if (c >= 0xdc00 && c <= 0xdfff)
+              {
+                return unpaired_surrogate();
+              }
+              // Combine surrogate pairs into single character.
+              else if (c >= 0xd800 && c <= 0xdbff)
+              {
+                const auto high = c;
+
+                if (m_end - m_current < 6
+                    || m_current[0] != '\\'
+                    || m_current[1] != 'u')
+                {
+                  return unpaired_surrogate();
+                }
+                m_current += 2;
+                if (!parse_hex(c))
+                {
+                  return false;
+                }
+                else if (c < 0xdc00 || c > 0xdfff)
+                {
+                  return unpaired_surrogate();
+                }
+                c = 0x10000 + ((high - 0xd800) << 10) + (c - 0xdc00);
+              }
+              break;
+
+            default:
+              --m_current;
+
+              return unexpected();
+          }
+          output.append(1, c);
+
+          return true;
+        }
+
+        bool enter()
+        {
+          if (++m_depth > PLORTH_JSON_MAX_DEPTH)
+          {
+            m_context->error(
+              error::code::range,
+              U"JSON input is nested too deeply."
+            );
+
+            return false;
+          }
+          ++m_current;
+          skip_whitespace();
+
+          return true;
+        }
+
+        bool parse_array(std::shared_ptr<value>& slot)
+        {
+          std::vector<std::shared_ptr<value>> elements;
+
+          if (!enter())
+          {
+            return false;
+          }
+          if (m_current < m_end && *m_current == ']')
+          {
+            ++m_current;
+          } else {
+            for (;;)
+            {
+              std::shared_ptr<value> element;
+
+              if (!parse_value(element))
+              {
+                return false;
+              }
+              elements.push_back(element);
+              skip_whitespace();
+              if (m_current >= m_end)
+              {
+                return unexpected();
+              }
+              else if (*m_current == ']')
+              {
+                ++m_current;
+                break;
+              }
+              else if (*m_current++ != ',')
+              {
+                --m_current;
+
+                return unexpected();
+              }
+            }
+          }
+          --m_depth;
+          slot = m_runtime->array(elements.data(), elements.size());
+
+          return true;
+        }
+
+        bool parse_object(std::shared_ptr<value>& slot)
+        {
+          std::vector<object::value_type> properties;
+
+          if (!enter())
+          {
+            return false;
+          }
+          if (m_current < m_end && *m_current == '}')
+          {
+            ++m_current;
+          } else {
+            for (;;)
+            {
+              object::key_type key;
+              std::shared_ptr<value> property;
+
+              if (m_current >= m_end || *m_current != '"')
+              {
+                return unexpected();
+              }
+              else if (!parse_string(m_buffer))
+              {
+                return false;
+              }
+              key = m_buffer;
+              skip_whitespace();
+              if (m_current >= m_end || *m_current != ':')
+              {
+                return unexpected();
+              }
+              ++m_current;
+              if (!parse_value(property))
+              {
+                return false;
+              }
+              properties.emplace_back(std::move(key), std::move(property));
+              skip_whitespace();
+              if (m_current >= m_end)
+              {
+                return unexpected();
+              }
+              else if (*m_current == '}')
+              {
+                ++m_current;
+                break;
+              }
+              else if (*m_current != ',')
+              {
+                return unexpected();
+              }
+              ++m_current;
+              skip_whitespace();
+            }
+          }
+          --m_depth;
+          // Object construction keeps the first one of duplicate properties,
+          // while in JSON the last one should win.
+          std::reverse(std::begin(properties), std::end(properties));
+          slot = m_runtime->object(properties);
+
+          return true;
+        }
+
+      private:
+        const std::shared_ptr<context>& m_context;
+        const std::shared_ptr<class runtime>& m_runtime;
+        const unsigned char* m_current;
+        const unsigned char* const m_end;
+        int m_depth;
+        /** Buffer used for decoding strings. */
+        std::u32string m_buffer;
+        /** Buffer used for converting numbers. */
+        std::string m_number;
+      };
+
+      static void stringify_real(number::real_type value,
+                                 std::u32string& output)
+      {
+        char buffer[32];
+
+        // Use the shortest representation which survives the round trip.
+        std::snprintf(buffer, sizeof(buffer), "%.15g", value);
+        if (std::strtod(buffer, nullptr) != value)
+        {
+          std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+        }
+        for (const char* p = buffer; *p; ++p)
+        {
+          output.append(1, static_cast<char32_t>(*p));
+        }
+      }
+    }
+
+    bool parse(const std::shared_ptr<context>& ctx,
+               const std::shared_ptr<string>& input,
+               std::shared_ptr<value>& slot)
+    {
+      std::string encoded;
+      const unsigned char* bytes;
+      std::size_t length;
+
+#if PLORTH_ENABLE_FILE_IO
+      // Contents of files are already encoded in UTF-8, so they can be
+      // parsed as they are.
+      if (!io::encoded_bytes(input, bytes, length))
+#endif
+      {
+        encoded = utf8_encode(input->to_string());
+        bytes = reinterpret_cast<const unsigned char*>(encoded.data());
+        length = encoded.length();
+      }
+
+      return parser(ctx, bytes, bytes + length).parse(slot);
+    }
+
+    bool stringify(const std::shared_ptr<context>& ctx,
+                   const std::shared_ptr<value>& value,
+                   std::u32string& output)
+    {
+      if (!value)
+      {
+        output.append(U"null");
+
+        return true;
+      }
+      switch (value->type())
+      {
+        case value::type::boolean:
+          output.append(
+            std::static_pointer_cast<boolean>(value)->value()
+              ? U"true"
+              : U"false"
+          );
+          break;
+
+        case value::type::number:
+          {
+            const auto num = std::static_pointer_cast<number>(value);
+
+            if (num->is(number::number_type::integer))
+            {
+              output.append(to_unistring(num->as_int()));
+            }
+            else if (std::isfinite(num->as_real()))
+            {
+              stringify_real(num->as_real(), output);
+            } else {
+              ctx->error(
+                error::code::value,
+                U"Cannot convert non-finite number into JSON."
+              );
+
+              return false;
+            }
+          }
+          break;
+
+        case value::type::string:
+          json_stringify(
+            std::static_pointer_cast<string>(value)->to_string(),
+            output
+          );
+          break;
+
+        case value::type::array:
+          {
+            const auto ary = std::static_pointer_cast<array>(value);
+            const auto size = ary->size();
+
+            output.append(1, '[');
+            for (array::size_type i = 0; i < size; ++i)
+            {
+              if (i > 0)
+              {
+                output.append(1, ',');
+              }
+              if (!stringify(ctx, ary->at(i), output))
+              {
+                return false;
+              }
+            }
+            output.append(1, ']');
+          }
+          break;
+
+        case value::type::object:
+          {
+            bool first = true;
+
+            output.append(1, '{');
+            for (const auto& property : std::static_pointer_cast<object>(
+              value
+            )->entries())
+            {
+              if (first)
+              {
+                first = false;
+              } else {
+                output.append(1, ',');
+              }
+              json_stringify(property.first, output);
+              output.append(1, ':');
+              if (!stringify(ctx, property.second, output))
+              {
+                return false;
+              }
+            }
+            output.append(1, '}');
+          }
+          break;
+
+        default:
+          ctx->error(
+            error::code::value,
+            U"Cannot convert " + value->type_description() + U" into JSON."
+          );
+
+          return false;
+      }
+
+      return true;
+    }
+  }
+}
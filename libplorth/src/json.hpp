@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2017-2018, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PLORTH_JSON_HPP_GUARD
+#define PLORTH_JSON_HPP_GUARD
+
+#include <plorth/context.hpp>
+
+namespace plorth
+{
+  namespace json
+  {
+    /**
+     * Parses JSON document from given string and constructs Plorth values
+     * from it. Objects, arrays, strings, numbers, booleans and null are
+     * converted into their Plorth counterparts.
+     *
+     * \param ctx   Execution context used for error reporting.
+     * \param input String containing the JSON document.
+     * \param slot  Where the parsed value is assigned to.
+     * \return      Boolean flag telling whether the document was
+     *              successfully parsed or not.
+     */
+    bool parse(const std::shared_ptr<context>& ctx,
+               const std::shared_ptr<string>& input,
+               std::shared_ptr<value>& slot);
+
+    /**
+     * Serializes given value into JSON and appends the result into given
+     * output buffer. Only values which have a JSON counterpart can be
+     * serialized.
+     *
+     * \param ctx    Execution context used for error reporting.
+     * \param value  Value to serialize.
+     * \param output Where the JSON is appended into.
+     * \return       Boolean flag telling whether the value could be
+     *               serialized or not.
+     */
+    bool stringify(const std::shared_ptr<context>& ctx,
+                   const std::shared_ptr<value>& value,
+                   std::u32string& output);
+  }
+}
+
+#endif /* !PLORTH_JSON_HPP_GUARD */
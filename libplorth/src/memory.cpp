@@ -28,6 +28,9 @@
 # if !defined(PLORTH_MEMORY_POOL_SIZE)
 #  define PLORTH_MEMORY_POOL_SIZE (4096 * 32)
 # endif
+# if !defined(PLORTH_MEMORY_REGION_RECYCLE_LIMIT)
+#  define PLORTH_MEMORY_REGION_RECYCLE_LIMIT 8
+# endif
 #endif
 
 namespace plorth
@@ -35,37 +38,169 @@ namespace plorth
   namespace memory
   {
 #if PLORTH_ENABLE_MEMORY_POOL
-    static pool* pool_create();
+    static pool* pool_create(class manager*, std::size_t);
+    static void pool_reset(pool*);
     static slot* pool_allocate(pool*, std::size_t);
+    static slot* pool_slice(pool*, std::size_t);
+    static void pool_unlink(pool*&, pool*&, pool*);
+    static void pool_collect(pool*);
+
+    /** Memory most recently allocated by the calling thread. */
+    static thread_local void* last_allocation = nullptr;
 #endif
 
     manager::manager()
+      : m_region_depth(0)
+#if PLORTH_ENABLE_THREADS
+      , m_concurrency(0)
+#endif
 #if PLORTH_ENABLE_MEMORY_POOL
-      : m_pool_head(nullptr)
+      , m_pool_head(nullptr)
       , m_pool_tail(nullptr)
+      , m_region_head(nullptr)
+      , m_region_tail(nullptr)
+      , m_recycled_pools(nullptr)
+      , m_recycled_count(0)
+      , m_destroying(false)
 #endif
       {}
 
     manager::~manager()
     {
 #if PLORTH_ENABLE_MEMORY_POOL
+      pool* lists[] = { m_pool_tail, m_region_tail, m_recycled_pools };
       pool* current;
       pool* prev;
 
-      for (current = m_pool_tail; current; current = prev)
+      // Pools are no longer removed by the destructor of managed objects once
+      // we have begun to tear down the whole manager.
+      m_destroying = true;
+
+      for (auto list : lists)
       {
-        prev = current->prev;
-        for (struct slot* slot = current->used_head; slot; slot = slot->next)
+        for (current = list; current; current = current->prev)
         {
-          delete reinterpret_cast<managed*>(slot->memory);
+          for (;;)
+          {
+            struct slot* slot = current->used_head;
+            void (*destroy)(void*);
+
+            while (slot && !slot->object && !slot->destroy)
+            {
+              slot = slot->next;
+            }
+            if (!slot)
+            {
+              break;
+            }
+            if (slot->object)
+            {
+              delete reinterpret_cast<managed*>(slot->memory);
+              continue;
+            }
+
+            // Objects constructed through an allocator are still referenced
+            // by their control block, which may release them later on (e.g.
+            // when the object is part of a reference cycle), so they are
+            // remembered in order to not destroy them twice. Their memory
+            // is released when the pool is.
+            destroy = slot->destroy;
+            slot->destroy = nullptr;
+            m_disposed.insert(slot->instance);
+            destroy(slot->instance);
+          }
+        }
+      }
+      for (auto list : lists)
+      {
+        for (current = list; current; current = prev)
+        {
+          prev = current->prev;
+          std::free(static_cast<void*>(current));
         }
-        std::free(static_cast<void*>(current));
       }
 #endif
     }
 
     void* manager::allocate(std::size_t size)
     {
+#if PLORTH_ENABLE_THREADS && PLORTH_ENABLE_MEMORY_POOL
+      if (concurrent())
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        return last_allocation = allocate_unlocked(size);
+      }
+#endif
+#if PLORTH_ENABLE_MEMORY_POOL
+      return last_allocation = allocate_unlocked(size);
+#else
+      return allocate_unlocked(size);
+#endif
+    }
+
+    void manager::deallocate(void* pointer)
+    {
+#if PLORTH_ENABLE_THREADS && PLORTH_ENABLE_MEMORY_POOL
+      if (concurrent())
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        deallocate_unlocked(pointer);
+        return;
+      }
+#endif
+
+      deallocate_unlocked(pointer);
+    }
+
+    void manager::track(void* instance, void (*destroy)(void*))
+    {
+#if PLORTH_ENABLE_MEMORY_POOL
+      struct slot* slot;
+
+      if (!last_allocation)
+      {
+        return;
+      }
+      slot = reinterpret_cast<struct slot*>(
+        static_cast<char*>(last_allocation) - sizeof(struct slot)
+      );
+      if (static_cast<char*>(instance) >= slot->memory
+          && static_cast<char*>(instance) < slot->memory + slot->size)
+      {
+        slot->destroy = destroy;
+        slot->instance = instance;
+      }
+      last_allocation = nullptr;
+#endif
+    }
+
+    bool manager::disposed(const void* instance) const
+    {
+#if PLORTH_ENABLE_MEMORY_POOL
+      return m_destroying && m_disposed.find(instance) != m_disposed.end();
+#else
+      return false;
+#endif
+    }
+
+    void manager::begin_concurrency()
+    {
+#if PLORTH_ENABLE_THREADS
+      ++m_concurrency;
+#endif
+    }
+
+    void manager::end_concurrency()
+    {
+#if PLORTH_ENABLE_THREADS
+      --m_concurrency;
+#endif
+    }
+
+    void* manager::allocate_unlocked(std::size_t size)
+    {
 #if PLORTH_ENABLE_MEMORY_POOL
       const std::size_t remainder = size % 8;
       struct pool* pool;
@@ -76,6 +211,69 @@ namespace plorth
         size += 8 - remainder;
       }
 
+      // Allocations which do not fit into an ordinary memory pool are given a
+      // pool of their own, which is placed at the beginning of the list of
+      // memory pools so that it isn't looked into by further allocations.
+      if (size + sizeof(struct slot) > PLORTH_MEMORY_POOL_SIZE)
+      {
+        if (!(pool = pool_create(this, size + sizeof(struct slot))))
+        {
+          std::abort();
+        }
+        pool->large = true;
+        if ((pool->next = m_pool_head))
+        {
+          m_pool_head->prev = pool;
+        } else {
+          m_pool_tail = pool;
+        }
+        m_pool_head = pool;
+        slot = pool_slice(pool, size);
+
+        return static_cast<void*>(slot->memory);
+      }
+
+      // When an allocation region is active, slice the memory from the arena
+      // pools of the region without looking into free slots at all. Regions
+      // have no effect while other threads are using the manager, as their
+      // allocations would otherwise end up in the arena of the thread which
+      // began the region.
+      if (m_region_depth > 0 && !concurrent())
+      {
+        if (m_region_tail && (slot = pool_slice(m_region_tail, size)))
+        {
+          return static_cast<void*>(slot->memory);
+        }
+
+        // Reuse previously emptied arena pool if one is available.
+        if ((pool = m_recycled_pools))
+        {
+          m_recycled_pools = pool->prev;
+          --m_recycled_count;
+          pool_reset(pool);
+        }
+        else if (!(pool = pool_create(this, PLORTH_MEMORY_POOL_SIZE)))
+        {
+          std::abort();
+        }
+        pool->region = true;
+        pool->next = nullptr;
+        if ((pool->prev = m_region_tail))
+        {
+          m_region_tail->next = pool;
+        } else {
+          m_region_head = pool;
+        }
+        m_region_tail = pool;
+
+        if (!(slot = pool_slice(pool, size)))
+        {
+          std::abort();
+        }
+
+        return static_cast<void*>(slot->memory);
+      }
+
       // First go through existing memory pools and check whether we can slice
       // a slot from any of them.
       for (pool = m_pool_tail; pool; pool = pool->prev)
@@ -88,7 +286,7 @@ namespace plorth
 
       // If all existing pools are full, create a new one. If that one fails,
       // abort the entire process as it's a signal that we are out of memory.
-      if (!(pool = pool_create()))
+      if (!(pool = pool_create(this, PLORTH_MEMORY_POOL_SIZE)))
       {
         std::abort();
       }
@@ -120,16 +318,90 @@ namespace plorth
 #endif
     }
 
-    managed::managed() {}
+    void manager::begin_region()
+    {
+#if PLORTH_ENABLE_THREADS
+      std::unique_lock<std::mutex> lock(m_mutex, std::defer_lock);
 
-    managed::~managed() {}
+      if (concurrent())
+      {
+        lock.lock();
+      }
+#endif
 
-    void* managed::operator new(std::size_t size, class manager& manager)
+      ++m_region_depth;
+    }
+
+    void manager::end_region()
     {
-      return manager.allocate(size);
+#if PLORTH_ENABLE_MEMORY_POOL
+      pool* current;
+      pool* next;
+#endif
+#if PLORTH_ENABLE_THREADS
+      std::unique_lock<std::mutex> lock(m_mutex, std::defer_lock);
+
+      if (concurrent())
+      {
+        lock.lock();
+      }
+#endif
+
+      if (!m_region_depth || --m_region_depth > 0)
+      {
+        return;
+      }
+
+#if PLORTH_ENABLE_MEMORY_POOL
+      for (current = m_region_head; current; current = next)
+      {
+        next = current->next;
+        current->region = false;
+
+        // Arena pools without any live objects are released in bulk, or kept
+        // around for the next region.
+        if (!current->used_head)
+        {
+          if (m_recycled_count < PLORTH_MEMORY_REGION_RECYCLE_LIMIT)
+          {
+            current->prev = m_recycled_pools;
+            m_recycled_pools = current;
+            ++m_recycled_count;
+          } else {
+            std::free(static_cast<void*>(current));
+          }
+          continue;
+        }
+
+        // Pools containing objects which have escaped the region are promoted
+        // into ordinary memory pools, after the slots of objects which did not
+        // escape have been placed into the list of free slots.
+        pool_collect(current);
+        current->next = nullptr;
+        if ((current->prev = m_pool_tail))
+        {
+          m_pool_tail->next = current;
+        } else {
+          m_pool_head = current;
+        }
+        m_pool_tail = current;
+      }
+      m_region_head = m_region_tail = nullptr;
+#endif
     }
 
-    void managed::operator delete(void* pointer)
+    region::region(class manager& manager)
+      : m_manager(manager)
+    {
+      m_manager.begin_region();
+    }
+
+    region::~region()
+    {
+      m_manager.end_region();
+    }
+
+    void manager::deallocate_unlocked(void* pointer)
     {
 #if PLORTH_ENABLE_MEMORY_POOL
       struct slot* slot;
@@ -163,6 +435,43 @@ namespace plorth
         pool->used_tail = nullptr;
       }
 
+      if (m_destroying)
+      {
+        return;
+      }
+
+      if (pool->large)
+      {
+        pool_unlink(m_pool_head, m_pool_tail, pool);
+        std::free(static_cast<void*>(pool));
+        return;
+      }
+
+      // Arena pools are never searched for free slots, so there is no need
+      // to maintain free list for them. Once they become empty, they can be
+      // reused from the beginning.
+      if (pool->region)
+      {
+        if (!pool->used_head)
+        {
+          if (pool != m_region_tail)
+          {
+            pool_unlink(m_region_head, m_region_tail, pool);
+            if (m_recycled_count < PLORTH_MEMORY_REGION_RECYCLE_LIMIT)
+            {
+              pool->prev = m_recycled_pools;
+              m_recycled_pools = pool;
+              ++m_recycled_count;
+            } else {
+              std::free(static_cast<void*>(pool));
+            }
+          } else {
+            pool_reset(pool);
+          }
+        }
+        return;
+      }
+
       // Then place the slot into linked of list of free slots in the pool.
       slot->next = nullptr;
       if ((slot->prev = slot->pool->free_tail))
@@ -191,10 +500,44 @@ namespace plorth
 #endif
     }
 
+    managed::managed() {}
+
+    managed::~managed() {}
+
+    void* managed::operator new(std::size_t size, class manager& manager)
+    {
+      void* pointer = manager.allocate(size);
+
+#if PLORTH_ENABLE_MEMORY_POOL
+      reinterpret_cast<struct slot*>(
+        static_cast<char*>(pointer) - sizeof(struct slot)
+      )->object = true;
+#endif
+
+      return pointer;
+    }
+
+    void managed::operator delete(void* pointer)
+    {
+#if PLORTH_ENABLE_MEMORY_POOL
+      if (pointer)
+      {
+        reinterpret_cast<struct slot*>(
+          static_cast<char*>(pointer) - sizeof(struct slot)
+        )->pool->manager->deallocate(pointer);
+      }
+#else
+      if (pointer)
+      {
+        std::free(pointer);
+      }
+#endif
+    }
+
 #if PLORTH_ENABLE_MEMORY_POOL
-    static pool* pool_create()
+    static pool* pool_create(class manager* manager, std::size_t capacity)
     {
-      char* memory = static_cast<char*>(std::malloc(sizeof(struct pool) + PLORTH_MEMORY_POOL_SIZE));
+      char* memory = static_cast<char*>(std::malloc(sizeof(struct pool) + capacity));
       struct pool* pool;
 
       if (!memory)
@@ -203,22 +546,96 @@ namespace plorth
       }
 
       pool = reinterpret_cast<struct pool*>(memory);
+      pool->manager = manager;
+      pool->region = false;
+      pool->large = false;
+      pool->capacity = capacity;
       pool->next = nullptr;
       pool->prev = nullptr;
-      pool->remaining = PLORTH_MEMORY_POOL_SIZE;
       pool->memory = memory + sizeof(struct pool);
+      pool_reset(pool);
+
+      return pool;
+    }
+
+    static void pool_reset(struct pool* pool)
+    {
+      pool->remaining = pool->capacity;
       pool->free_head = nullptr;
       pool->free_tail = nullptr;
       pool->used_head = nullptr;
       pool->used_tail = nullptr;
+    }
 
-      return pool;
+    static void pool_unlink(struct pool*& head,
+                            struct pool*& tail,
+                            struct pool* pool)
+    {
+      if (pool->prev)
+      {
+        pool->prev->next = pool->next;
+      } else {
+        head = pool->next;
+      }
+      if (pool->next)
+      {
+        pool->next->prev = pool->prev;
+      } else {
+        tail = pool->prev;
+      }
+      pool->next = pool->prev = nullptr;
+    }
+
+    /**
+     * Goes through the slots sliced from an arena pool and places every slot
+     * which is no longer in use into the list of free slots of the pool, so
+     * that the memory can be reused once the pool has been promoted into an
+     * ordinary memory pool. Adjacent unused slots are merged together.
+     */
+    static void pool_collect(struct pool* pool)
+    {
+      const char* end = pool->memory + (pool->capacity - pool->remaining);
+      struct slot* used = pool->used_head;
+      struct slot* free = nullptr;
+      char* memory = pool->memory;
+
+      pool->free_head = pool->free_tail = nullptr;
+      while (memory < end)
+      {
+        struct slot* slot = reinterpret_cast<struct slot*>(memory);
+
+        memory += sizeof(struct slot) + slot->size;
+
+        // Slots in the list of used slots are in the same order as they were
+        // sliced from the pool.
+        if (slot == used)
+        {
+          used = used->next;
+          free = nullptr;
+          continue;
+        }
+
+        if (free)
+        {
+          free->size += sizeof(struct slot) + slot->size;
+          continue;
+        }
+
+        free = slot;
+        slot->next = nullptr;
+        if ((slot->prev = pool->free_tail))
+        {
+          pool->free_tail->next = slot;
+        } else {
+          pool->free_head = slot;
+        }
+        pool->free_tail = slot;
+      }
     }
 
     static slot* pool_allocate(struct pool* pool, std::size_t size)
     {
       struct slot* slot;
-      char* memory;
 
       for (slot = pool->free_head; slot; slot = slot->next)
       {
@@ -254,16 +671,30 @@ namespace plorth
           pool->used_head = slot;
         }
         pool->used_tail = slot;
+        slot->object = false;
+        slot->destroy = nullptr;
 
         return slot;
       }
 
+      return pool_slice(pool, size);
+    }
+
+    /**
+     * Slices new slot from the unused memory of the pool, without looking at
+     * the free slots of the pool.
+     */
+    static slot* pool_slice(struct pool* pool, std::size_t size)
+    {
+      struct slot* slot;
+      char* memory;
+
       if (pool->remaining < size + sizeof(struct slot))
       {
         return nullptr;
       }
 
-      memory = pool->memory + (PLORTH_MEMORY_POOL_SIZE - pool->remaining);
+      memory = pool->memory + (pool->capacity - pool->remaining);
       pool->remaining -= size + sizeof(struct slot);
 
       slot = reinterpret_cast<struct slot*>(memory);
@@ -278,6 +709,8 @@ namespace plorth
       pool->used_tail = slot;
       slot->size = size;
       slot->memory = memory + sizeof(struct slot);
+      slot->object = false;
+      slot->destroy = nullptr;
 
       return slot;
     }
@@ -42,6 +42,11 @@
 #include <algorithm>
 #include <cstring>
 
+#if PLORTH_ENABLE_FILE_SYSTEM_MODULES && PLORTH_ENABLE_MODULE_CACHE
+# include <cstdio>
+# include <cstdlib>
+# include "./serialization.hpp"
+#endif
 #include "./utils.hpp"
 
 namespace plorth
@@ -50,6 +55,10 @@ namespace plorth
                        const std::u32string& path)
   {
     std::shared_ptr<class object> module;
+#if PLORTH_ENABLE_THREADS
+    // Module manager is shared by all actors of the runtime.
+    std::lock_guard<std::recursive_mutex> lock(m_import_mutex);
+#endif
 
     // Do not allow importing anything if the runtime does not have a module
     // manager.
@@ -111,6 +120,15 @@ namespace plorth
 
     static bool is_absolute_path(const std::u32string&);
     static std::u32string dirname(const std::u32string&);
+# if PLORTH_ENABLE_MODULE_CACHE
+    static bool module_cache_load(const std::shared_ptr<runtime>&,
+                                  const std::u32string&,
+                                  const std::string&,
+                                  std::shared_ptr<quote>&);
+    static void module_cache_store(const std::u32string&,
+                                   const std::string&,
+                                   const std::shared_ptr<quote>&);
+# endif
 #endif
 
     namespace
@@ -353,7 +371,6 @@ namespace plorth
         {
           std::ifstream is(utf8_encode(path));
           std::string raw_source;
-          std::u32string source;
           std::shared_ptr<quote> compiled_module;
           std::shared_ptr<context> module_ctx;
           std::vector<object::value_type> result;
@@ -375,21 +392,27 @@ namespace plorth
           );
           is.close();
 
-          // First decode the source code with UTF-8 character encoding.
-          if (!utf8_decode_test(raw_source, source))
+#if PLORTH_ENABLE_MODULE_CACHE
+          // See whether compiled form of the module can be found from the
+          // module cache, in which case parsing and compilation of the source
+          // code can be skipped.
+          if (!module_cache_load(ctx->runtime(),
+                                 path,
+                                 raw_source,
+                                 compiled_module))
+#endif
           {
-            ctx->error(
-              error::code::import,
-              U"Unable to decode source code into UTF-8."
-            );
-
-            return std::shared_ptr<object>();
-          }
+            // Compile the source code directly from it's UTF-8 encoded form.
+            if (!(compiled_module = ctx->compile(raw_source.c_str(),
+                                                 raw_source.length(),
+                                                 path)))
+            {
+              return std::shared_ptr<object>();
+            }
 
-          // Then attempt to compile it.
-          if (!(compiled_module = ctx->compile(source, path)))
-          {
-            return std::shared_ptr<object>();
+#if PLORTH_ENABLE_MODULE_CACHE
+            module_cache_store(path, raw_source, compiled_module);
+#endif
           }
 
           // Run the module code inside new execution context.
@@ -536,6 +559,243 @@ namespace plorth
         return path.substr(0, index);
       }
     }
+
+# if PLORTH_ENABLE_MODULE_CACHE
+    /** Magic bytes found in the beginning of each module cache file. */
+    static const char module_cache_magic[] = "PLORTHC";
+    /** Version of the module cache file format. */
+    static const std::uint64_t module_cache_format = 1;
+
+    /**
+     * 64-bit FNV-1a hash of given bytes. Used both for naming the module
+     * cache files and for detecting whether module source code has changed
+     * since the module cache file was written.
+     */
+    static std::uint64_t fnv1a(const std::string& input)
+    {
+      std::uint64_t hash = UINT64_C(0xcbf29ce484222325);
+
+      for (const auto c : input)
+      {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= UINT64_C(0x100000001b3);
+      }
+
+      return hash;
+    }
+
+    /**
+     * Creates given directory and all of it's parent directories, unless
+     * they already exist.
+     */
+    static bool make_directories(const std::string& path)
+    {
+      struct ::stat st;
+
+      if (path.empty() || !::stat(path.c_str(), &st))
+      {
+        return !path.empty() && S_ISDIR(st.st_mode);
+      }
+
+      const auto index = path.find_last_of(file_separator);
+
+      if (index != std::string::npos && index > 0)
+      {
+        make_directories(path.substr(0, index));
+      }
+
+      return !::mkdir(path.c_str(), 0755);
+    }
+
+    /**
+     * Determines the directory where module cache files are stored into.
+     * Uses `PLORTH_CACHE_DIR` environment variable when it's set, setting it
+     * into an empty string disables the module cache. Otherwise falls back to
+     * `$XDG_CACHE_HOME/plorth` or `$HOME/.cache/plorth`.
+     *
+     * \return Path of the cache directory or empty string if module cache
+     *         cannot be used.
+     */
+    static std::string module_cache_directory()
+    {
+      std::string directory;
+
+      if (const auto value = std::getenv("PLORTH_CACHE_DIR"))
+      {
+        directory = value;
+      }
+      else if (const auto value = std::getenv("XDG_CACHE_HOME"))
+      {
+        if (*value)
+        {
+          directory = std::string(value) + file_separator + "plorth";
+        }
+      }
+      else if (const auto value = std::getenv("HOME"))
+      {
+        if (*value)
+        {
+          directory = std::string(value) + file_separator + ".cache"
+            + file_separator + "plorth";
+        }
+      }
+
+      if (directory.empty() || !make_directories(directory))
+      {
+        return std::string();
+      }
+
+      return directory;
+    }
+
+    /**
+     * Constructs path of the module cache file used for module located in
+     * given path.
+     */
+    static std::string module_cache_path(const std::string& directory,
+                                         const std::string& path)
+    {
+      static const char digits[] = "0123456789abcdef";
+      auto hash = fnv1a(path);
+      std::string name(16, '0');
+
+      for (auto i = name.length(); i > 0; --i)
+      {
+        name[i - 1] = digits[hash & 0xf];
+        hash >>= 4;
+      }
+
+      return directory + file_separator + name + ".plorthc";
+    }
+
+    /**
+     * Writes header of module cache file, which is used to detect whether
+     * the cache file is stale or not. Stale cache files are simply ignored
+     * and overwritten once the module has been compiled again.
+     */
+    static bool module_cache_header(const std::string& path,
+                                    const std::string& raw_source,
+                                    std::string& output)
+    {
+      serialization::writer writer(output);
+      struct ::stat st;
+
+      if (::stat(path.c_str(), &st) < 0)
+      {
+        return false;
+      }
+      writer.write_bytes(module_cache_magic, sizeof(module_cache_magic));
+      writer.write_uint(module_cache_format);
+      writer.write_string(PLORTH_VERSION);
+      writer.write_string(utf8_decode(path));
+      writer.write_uint(static_cast<std::uint64_t>(st.st_mtime));
+      writer.write_uint(raw_source.length());
+      writer.write_uint(fnv1a(raw_source));
+
+      return true;
+    }
+
+    static bool module_cache_load(const std::shared_ptr<runtime>& runtime,
+                                  const std::u32string& path,
+                                  const std::string& raw_source,
+                                  std::shared_ptr<quote>& slot)
+    {
+      const auto directory = module_cache_directory();
+      const auto encoded_path = utf8_encode(path);
+      std::string header;
+      std::string data;
+      std::shared_ptr<value> result;
+
+      if (directory.empty()
+          || !module_cache_header(encoded_path, raw_source, header))
+      {
+        return false;
+      }
+
+      std::ifstream is(
+        module_cache_path(directory, encoded_path),
+        std::ios_base::in | std::ios_base::binary
+      );
+
+      if (!is.good())
+      {
+        return false;
+      }
+
+      data = std::string(
+        std::istreambuf_iterator<char>(is),
+        std::istreambuf_iterator<char>()
+      );
+      is.close();
+
+      serialization::reader reader(runtime, data.c_str(), data.length());
+
+      if (!reader.expect_bytes(header.c_str(), header.length())
+          || !reader.read_value(result)
+          || !reader.eof()
+          || !value::is(result, value::type::quote)
+          || !compiled_quote_values(std::static_pointer_cast<quote>(result)))
+      {
+        return false;
+      }
+      slot = std::static_pointer_cast<quote>(result);
+
+      return true;
+    }
+
+    static void module_cache_store(const std::u32string& path,
+                                   const std::string& raw_source,
+                                   const std::shared_ptr<quote>& compiled)
+    {
+      const auto directory = module_cache_directory();
+      const auto encoded_path = utf8_encode(path);
+      std::string data;
+      std::string cache_path;
+      std::string temp_path;
+
+      if (directory.empty()
+          || !module_cache_header(encoded_path, raw_source, data))
+      {
+        return;
+      }
+
+      serialization::writer writer(data);
+
+      if (!writer.write_value(compiled))
+      {
+        return;
+      }
+
+      // Write into temporary file first and then rename it over the actual
+      // cache file, so that concurrent imports never see partially written
+      // cache files.
+      cache_path = module_cache_path(directory, encoded_path);
+      temp_path = cache_path + "." + std::to_string(::getpid()) + ".tmp";
+      {
+        std::ofstream os(
+          temp_path,
+          std::ios_base::out | std::ios_base::binary | std::ios_base::trunc
+        );
+
+        if (!os.good())
+        {
+          return;
+        }
+        os.write(data.c_str(), data.length());
+        if (!os.good())
+        {
+          os.close();
+          std::remove(temp_path.c_str());
+
+          return;
+        }
+      }
+      if (std::rename(temp_path.c_str(), cache_path.c_str()))
+      {
+        std::remove(temp_path.c_str());
+      }
+    }
+# endif
 #endif
   }
 }
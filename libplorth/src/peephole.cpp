@@ -0,0 +1,516 @@
+/*
+ * Copyright (c) 2017-2018, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "./peephole.hpp"
+#include "./utils.hpp"
+
+namespace plorth
+{
+  namespace peephole
+  {
+    static const char32_t* fused_words[] =
+    {
+      U"dup",
+      U"drop",
+      U"over",
+      U"rot",
+      U"swap",
+      U"+",
+      U"-",
+      U"*",
+      U"@",
+      nullptr
+    };
+
+    static inline bool is_symbol(const std::shared_ptr<value>& val,
+                                 const char32_t* id)
+    {
+      return value::is(val, value::type::symbol) &&
+        !std::static_pointer_cast<symbol>(val)->id().compare(id);
+    }
+
+    static inline bool is_number_literal(const std::shared_ptr<value>& val)
+    {
+      return value::is(val, value::type::symbol) &&
+        is_number(std::static_pointer_cast<symbol>(val)->id());
+    }
+
+    /**
+     * Returns true if given value cannot have user defined prototype, i.e.
+     * words cannot be overridden by the value.
+     */
+    static inline bool is_plain(const std::shared_ptr<value>& val)
+    {
+      return !val || val->type() != value::type::object;
+    }
+
+    static inline bool is_number_value(const std::shared_ptr<value>& val)
+    {
+      return val && val->type() == value::type::number;
+    }
+
+    /**
+     * Returns opcode used for executing single value of a compiled quote.
+     * Words of the number prototype are executed directly when applied to
+     * numbers.
+     */
+    static enum opcode single_opcode(const std::shared_ptr<value>& val)
+    {
+      static const struct
+      {
+        const char32_t* id;
+        enum opcode opcode;
+      } number_words[] =
+      {
+        { U"+", opcode::add },
+        { U"-", opcode::sub },
+        { U"*", opcode::mul },
+        { U"/", opcode::div },
+        { U"%", opcode::mod },
+        { U"<", opcode::lt },
+        { U">", opcode::gt },
+        { U"<=", opcode::lte },
+        { U">=", opcode::gte },
+        { nullptr, opcode::exec }
+      };
+
+      if (value::is(val, value::type::symbol))
+      {
+        for (auto word = number_words; word->id; ++word)
+        {
+          if (is_symbol(val, word->id))
+          {
+            return word->opcode;
+          }
+        }
+      }
+
+      return opcode::exec;
+    }
+
+    static instruction make_instruction(
+      enum opcode code,
+      const std::vector<std::shared_ptr<value>>& values,
+      std::size_t offset,
+      std::size_t length,
+      const std::shared_ptr<value>& operand = std::shared_ptr<value>()
+    )
+    {
+      const auto& last = values[offset + length - 1];
+      instruction result;
+
+      result.opcode = code;
+      result.offset = offset;
+      result.length = length;
+      result.operand = operand;
+      if (value::is(last, value::type::symbol))
+      {
+        result.position = std::static_pointer_cast<symbol>(last)->position();
+      } else {
+        result.position = nullptr;
+      }
+
+      return result;
+    }
+
+    std::vector<instruction> optimize(
+      class runtime* runtime,
+      const std::vector<std::shared_ptr<value>>& values
+    )
+    {
+      const auto size = values.size();
+      std::vector<instruction> result;
+      std::shared_ptr<value> builtin_get;
+
+      if (runtime->object_prototype())
+      {
+        runtime->object_prototype()->own_property(U"@", builtin_get);
+      }
+
+      result.reserve(size);
+      for (std::size_t i = 0; i < size;)
+      {
+        const auto& first = values[i];
+
+        if (i + 2 < size &&
+            builtin_get &&
+            value::is(first, value::type::string) &&
+            is_symbol(values[i + 1], U"swap") &&
+            is_symbol(values[i + 2], U"@"))
+        {
+          auto ins = make_instruction(
+            opcode::get_literal,
+            values,
+            i,
+            3,
+            builtin_get
+          );
+
+          ins.key = first->to_string();
+          result.push_back(ins);
+          i += 3;
+          continue;
+        }
+
+        if (i + 1 < size)
+        {
+          const auto& second = values[i + 1];
+          auto code = opcode::exec;
+          std::shared_ptr<value> operand;
+
+          if (is_symbol(first, U"dup"))
+          {
+            if (is_symbol(second, U"*"))
+            {
+              code = opcode::square;
+            }
+            else if (is_symbol(second, U"drop"))
+            {
+              code = opcode::nop;
+            }
+          }
+          else if (is_symbol(first, U"swap"))
+          {
+            if (is_symbol(second, U"drop"))
+            {
+              code = opcode::nip;
+            }
+            else if (is_symbol(second, U"swap"))
+            {
+              code = opcode::nop;
+            }
+          }
+          else if (is_symbol(first, U"over") && is_symbol(second, U"+"))
+          {
+            code = opcode::over_add;
+          }
+          else if (is_symbol(first, U"rot") && is_symbol(second, U"rot"))
+          {
+            code = opcode::rot_rot;
+          }
+          else if (is_number_literal(first))
+          {
+            if (is_symbol(second, U"+"))
+            {
+              code = opcode::add_literal;
+            }
+            else if (is_symbol(second, U"-"))
+            {
+              code = opcode::sub_literal;
+            }
+            if (code != opcode::exec)
+            {
+              operand = runtime->number(
+                std::static_pointer_cast<symbol>(first)->id()
+              );
+            }
+          }
+
+          if (code != opcode::exec)
+          {
+            result.push_back(make_instruction(code, values, i, 2, operand));
+            i += 2;
+            continue;
+          }
+        }
+
+        result.push_back(make_instruction(single_opcode(first), values, i, 1));
+        ++i;
+      }
+
+      return result;
+    }
+
+    bool is_applicable(const std::shared_ptr<context>& ctx,
+                       const instruction& instruction)
+    {
+      const auto& stack = ctx->data();
+      const auto size = stack.size();
+      const auto& runtime = ctx->runtime();
+
+      switch (instruction.opcode)
+      {
+        // Words of the number prototype take precedence over dictionaries
+        // when there is a number on top of the stack, so they cannot be
+        // shadowed.
+        case opcode::add:
+        case opcode::sub:
+        case opcode::mul:
+        case opcode::div:
+        case opcode::mod:
+        case opcode::lt:
+        case opcode::gt:
+        case opcode::lte:
+        case opcode::gte:
+          return size >= 2 && is_number_value(stack[size - 1])
+            && is_number_value(stack[size - 2]);
+
+        default:
+          break;
+      }
+
+      if (ctx->dictionary().shadows_builtins() ||
+          runtime->dictionary().shadows_builtins())
+      {
+        return false;
+      }
+
+      switch (instruction.opcode)
+      {
+        case opcode::nop:
+        case opcode::nip:
+          return size >= 2 && is_plain(stack[size - 1])
+            && is_plain(stack[size - 2]);
+
+        case opcode::square:
+        case opcode::add_literal:
+        case opcode::sub_literal:
+          return size >= 1 && is_number_value(stack[size - 1]);
+
+        case opcode::over_add:
+          return size >= 2 && is_number_value(stack[size - 1])
+            && is_number_value(stack[size - 2]);
+
+        case opcode::get_literal:
+          if (size >= 1 && value::is(stack[size - 1], value::type::object))
+          {
+            const auto prototype = stack[size - 1]->prototype(runtime);
+            std::shared_ptr<value> slot;
+
+            return prototype
+              && prototype->property(runtime, U"@", slot)
+              && slot.get() == instruction.operand.get();
+          }
+          return false;
+
+        case opcode::rot_rot:
+          return size >= 3 && is_plain(stack[size - 1])
+            && is_plain(stack[size - 2])
+            && is_plain(stack[size - 3]);
+
+        default:
+          return false;
+      }
+    }
+
+    bool execute(const std::shared_ptr<context>& ctx,
+                 const instruction& instruction,
+                 const std::vector<std::shared_ptr<value>>& values)
+    {
+      if (!is_applicable(ctx, instruction))
+      {
+        const auto end = instruction.offset + instruction.length;
+
+        for (auto i = instruction.offset; i < end; ++i)
+        {
+          if (!value::exec(ctx, values[i]))
+          {
+            return false;
+          }
+        }
+
+        return true;
+      }
+
+      auto& stack = ctx->data();
+      const auto& runtime = ctx->runtime();
+
+      if (instruction.position)
+      {
+        ctx->position() = *instruction.position;
+      }
+
+      switch (instruction.opcode)
+      {
+        case opcode::nop:
+          break;
+
+        case opcode::square:
+          {
+            auto& top = stack.back();
+            const auto& num = static_cast<const class number&>(*top);
+
+            number_mul(runtime, top, num, num);
+          }
+          break;
+
+        case opcode::nip:
+          stack.erase(stack.end() - 2);
+          break;
+
+        case opcode::over_add:
+          {
+            auto& top = stack.back();
+
+            number_add(
+              runtime,
+              top,
+              static_cast<const class number&>(*top),
+              static_cast<const class number&>(*stack[stack.size() - 2])
+            );
+          }
+          break;
+
+        case opcode::add_literal:
+        case opcode::sub_literal:
+          {
+            auto& top = stack.back();
+            const auto& num = static_cast<const class number&>(*top);
+            const auto& operand = static_cast<const class number&>(
+              *instruction.operand
+            );
+
+            if (instruction.opcode == opcode::add_literal)
+            {
+              number_add(runtime, top, num, operand);
+            } else {
+              number_sub(runtime, top, num, operand);
+            }
+          }
+          break;
+
+        case opcode::get_literal:
+          {
+            const auto obj = std::static_pointer_cast<object>(stack.back());
+            std::shared_ptr<value> slot;
+
+            if (!obj->property(runtime, instruction.key, slot))
+            {
+              ctx->error(
+                error::code::range,
+                U"No such property: `" + instruction.key + U"'"
+              );
+
+              return false;
+            }
+            stack.push_back(slot);
+          }
+          break;
+
+        case opcode::rot_rot:
+          {
+            const auto top = stack.back();
+
+            stack.pop_back();
+            stack.insert(stack.end() - 2, top);
+          }
+          break;
+
+        case opcode::add:
+        case opcode::sub:
+        case opcode::mul:
+        case opcode::div:
+        case opcode::mod:
+          {
+            const auto operand = std::move(stack.back());
+
+            stack.pop_back();
+
+            auto& top = stack.back();
+            const auto& a = static_cast<const class number&>(*top);
+            const auto& b = static_cast<const class number&>(*operand);
+
+            switch (instruction.opcode)
+            {
+              case opcode::add:
+                number_add(runtime, top, a, b);
+                break;
+
+              case opcode::sub:
+                number_sub(runtime, top, a, b);
+                break;
+
+              case opcode::mul:
+                number_mul(runtime, top, a, b);
+                break;
+
+              case opcode::div:
+                number_div(runtime, top, a, b);
+                break;
+
+              default:
+                number_mod(runtime, top, a, b);
+                break;
+            }
+          }
+          break;
+
+        case opcode::lt:
+        case opcode::gt:
+        case opcode::lte:
+        case opcode::gte:
+          {
+            const auto operand = std::move(stack.back());
+
+            stack.pop_back();
+
+            auto& top = stack.back();
+            const auto& a = static_cast<const class number&>(*top);
+            const auto& b = static_cast<const class number&>(*operand);
+            bool result;
+
+            switch (instruction.opcode)
+            {
+              case opcode::lt:
+                result = number_lt(a, b);
+                break;
+
+              case opcode::gt:
+                result = number_gt(a, b);
+                break;
+
+              case opcode::lte:
+                result = number_lte(a, b);
+                break;
+
+              default:
+                result = number_gte(a, b);
+                break;
+            }
+            top = runtime->boolean(result);
+          }
+          break;
+
+        default:
+          return value::exec(ctx, values[instruction.offset]);
+      }
+
+      return true;
+    }
+
+    bool is_fused_word(const std::u32string& id)
+    {
+      for (auto word = fused_words; *word; ++word)
+      {
+        if (!id.compare(*word))
+        {
+          return true;
+        }
+      }
+
+      return false;
+    }
+  }
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2017-2018, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PLORTH_PEEPHOLE_HPP_GUARD
+#define PLORTH_PEEPHOLE_HPP_GUARD
+
+#include <plorth/context.hpp>
+
+namespace plorth
+{
+  namespace peephole
+  {
+    /**
+     * Enumeration of different instructions that a compiled quote consists
+     * of.
+     */
+    enum class opcode
+    {
+      /** Executes single value as it is. */
+      exec,
+      /** Does nothing; `swap swap' or `dup drop'. */
+      nop,
+      /** Multiplies number with itself; `dup *'. */
+      square,
+      /** Removes the second topmost value; `swap drop'. */
+      nip,
+      /** Adds second topmost number to the topmost one; `over +'. */
+      over_add,
+      /** Adds number literal to the topmost number; `1 +'. */
+      add_literal,
+      /** Subtracts number literal from the topmost number; `1 -'. */
+      sub_literal,
+      /** Retrieves property of an object; `"key" swap @'. */
+      get_literal,
+      /** Moves the topmost value below two others; `rot rot'. */
+      rot_rot,
+      /** Adds two numbers; `+'. */
+      add,
+      /** Subtracts two numbers; `-'. */
+      sub,
+      /** Multiplies two numbers; `*'. */
+      mul,
+      /** Divides two numbers; `/'. */
+      div,
+      /** Computes modulo of two numbers; `%'. */
+      mod,
+      /** Compares two numbers; `<'. */
+      lt,
+      /** Compares two numbers; `>'. */
+      gt,
+      /** Compares two numbers; `<='. */
+      lte,
+      /** Compares two numbers; `>='. */
+      gte
+    };
+
+    /**
+     * Single instruction of a compiled quote, which covers one or more values
+     * of the quote.
+     */
+    struct instruction
+    {
+      /** Type of the instruction. */
+      enum opcode opcode;
+      /** Index of the first value covered by the instruction. */
+      std::size_t offset;
+      /** Number of values covered by the instruction. */
+      std::size_t length;
+      /** Number literal or built-in quote used by the instruction. */
+      std::shared_ptr<value> operand;
+      /** Name of the property retrieved by the instruction. */
+      std::u32string key;
+      /** Source code position of the last symbol covered, if any. */
+      const struct position* position;
+    };
+
+    /**
+     * Translates values of a compiled quote into sequence of instructions,
+     * where commonly used sequences of words are fused into single
+     * superinstructions.
+     *
+     * \param runtime Runtime where the quote is being compiled in.
+     * \param values  Values of the compiled quote.
+     * \return        Instructions for executing the values.
+     */
+    std::vector<instruction> optimize(
+      class runtime* runtime,
+      const std::vector<std::shared_ptr<value>>& values
+    );
+
+    /**
+     * Tests whether the superinstruction can be executed in the current state
+     * of the context, i.e. whether it would produce exactly the same result
+     * as executing the words it consists of one by one.
+     */
+    bool is_applicable(const std::shared_ptr<context>& ctx,
+                       const instruction& instruction);
+
+    /**
+     * Executes given superinstruction. If the superinstruction cannot be used
+     * in the current state of the context, values covered by it are executed
+     * one by one instead.
+     *
+     * \param ctx         Execution context.
+     * \param instruction Instruction to execute.
+     * \param values      Values of the compiled quote.
+     * \return            Boolean flag telling whether the execution was
+     *                    successful or not.
+     */
+    bool execute(const std::shared_ptr<context>& ctx,
+                 const instruction& instruction,
+                 const std::vector<std::shared_ptr<value>>& values);
+
+    /**
+     * Returns true if given word is used in any of the superinstructions, in
+     * which case user defined words with the same name must disable them.
+     */
+    bool is_fused_word(const std::u32string& id);
+  }
+}
+
+#endif /* !PLORTH_PEEPHOLE_HPP_GUARD */
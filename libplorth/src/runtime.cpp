@@ -28,6 +28,7 @@
 #include <plorth/value-quote.hpp>
 
 #include <cassert>
+#include <cmath>
 
 namespace plorth
 {
@@ -40,6 +41,7 @@ namespace plorth
     runtime::prototype_definition number_prototype();
     runtime::prototype_definition object_prototype();
     runtime::prototype_definition quote_prototype();
+    runtime::prototype_definition sequence_prototype();
     runtime::prototype_definition string_prototype();
     runtime::prototype_definition symbol_prototype();
     runtime::prototype_definition word_prototype();
@@ -72,13 +74,99 @@ namespace plorth
     return runtime;
   }
 
+  std::shared_ptr<runtime> runtime::make(
+    memory::manager& memory_manager,
+    const std::shared_ptr<class runtime>& base,
+    const std::shared_ptr<io::input>& input,
+    const std::shared_ptr<io::output>& output,
+    const std::shared_ptr<module::manager>& module_manager
+  )
+  {
+    const auto runtime = std::shared_ptr<class runtime>(
+      new (memory_manager) class runtime(&memory_manager, base)
+    );
+
+    runtime->m_input = input ? input : io::input::standard(memory_manager);
+    runtime->m_output = output ? output : io::output::standard(memory_manager);
+    runtime->m_module_manager =
+      module_manager ?
+      module_manager :
+      module::manager::file_system(memory_manager);
+
+    return runtime;
+  }
+
+  runtime::runtime(memory::manager* memory_manager,
+                   const std::shared_ptr<class runtime>& base)
+    : m_memory_manager(memory_manager)
+    , m_base(base)
+    , m_dictionary(&base->m_dictionary)
+    , m_true_value(base->m_true_value)
+    , m_false_value(base->m_false_value)
+    , m_empty_string(base->m_empty_string)
+    , m_empty_array(base->m_empty_array)
+    , m_empty_object(base->m_empty_object)
+    , m_real_zero(base->m_real_zero)
+    , m_real_one(base->m_real_one)
+    , m_real_nan(base->m_real_nan)
+    , m_real_infinity(base->m_real_infinity)
+    , m_array_prototype(base->m_array_prototype)
+    , m_boolean_prototype(base->m_boolean_prototype)
+    , m_error_prototype(base->m_error_prototype)
+    , m_number_prototype(base->m_number_prototype)
+    , m_object_prototype(base->m_object_prototype)
+    , m_quote_prototype(base->m_quote_prototype)
+    , m_sequence_prototype(base->m_sequence_prototype)
+    , m_string_prototype(base->m_string_prototype)
+    , m_symbol_prototype(base->m_symbol_prototype)
+    , m_word_prototype(base->m_word_prototype)
+#if PLORTH_ENABLE_INTEGER_CACHE
+    , m_integer_cache(base->m_integer_cache)
+#endif
+#if PLORTH_ENABLE_THREADS
+    , m_actors(this)
+#endif
+  {
+    assert(memory_manager);
+    assert(base);
+  }
+
   runtime::runtime(memory::manager* memory_manager)
     : m_memory_manager(memory_manager)
+#if PLORTH_ENABLE_THREADS
+    , m_actors(this)
+#endif
   {
     assert(memory_manager);
 
     m_true_value = value<class boolean>(true);
     m_false_value = value<class boolean>(false);
+    m_empty_string = string(nullptr, 0);
+    m_empty_array = array(nullptr, 0);
+    m_empty_object = object({});
+    m_real_zero = value<class number>(0.0);
+    m_real_one = value<class number>(1.0);
+    m_real_nan = value<class number>(NAN);
+    m_real_infinity = value<class number>(INFINITY);
+
+#if PLORTH_ENABLE_INTEGER_CACHE
+    {
+      auto integer_cache = std::make_shared<
+        std::vector<std::shared_ptr<class number>>
+      >();
+
+      integer_cache->reserve(
+        PLORTH_INTEGER_CACHE_MAX - PLORTH_INTEGER_CACHE_MIN + 1
+      );
+      for (number::int_type i = PLORTH_INTEGER_CACHE_MIN;
+           i <= PLORTH_INTEGER_CACHE_MAX;
+           ++i)
+      {
+        integer_cache->push_back(value<class number>(i));
+      }
+      m_integer_cache = integer_cache;
+    }
+#endif
 
     for (auto& entry : api::global_dictionary())
     {
@@ -118,6 +206,11 @@ namespace plorth
       U"quote",
       api::quote_prototype()
     );
+    m_sequence_prototype = make_prototype(
+      this,
+      U"sequence",
+      api::sequence_prototype()
+    );
     m_string_prototype = make_prototype(
       this,
       U"string",
@@ -133,6 +226,8 @@ namespace plorth
       U"word",
       api::word_prototype()
     );
+
+    m_dictionary.mark_builtins();
   }
 
   io::input::result runtime::read(io::input::size_type size,
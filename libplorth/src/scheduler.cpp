@@ -0,0 +1,373 @@
+/*
+ * Copyright (c) 2017-2018, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <plorth/context.hpp>
+#include <plorth/scheduler.hpp>
+
+#if PLORTH_ENABLE_GREEN_THREADS
+# include <cassert>
+
+# include <ucontext.h>
+# if HAVE_SYS_EPOLL_H
+#  include <sys/epoll.h>
+#  include <unistd.h>
+# else
+#  include <poll.h>
+# endif
+
+# if !defined(PLORTH_GREEN_THREAD_STACK_SIZE)
+#  define PLORTH_GREEN_THREAD_STACK_SIZE (1024 * 1024)
+# endif
+
+namespace plorth
+{
+  struct scheduler::task
+  {
+    /** Saved machine context of the task. */
+    ucontext_t machine_context;
+    /** Call stack of the task, or null for the root task. */
+    std::unique_ptr<char[]> stack;
+    /** Execution context of the task. */
+    std::shared_ptr<class context> context;
+    /** Quote executed by the task. */
+    std::shared_ptr<class quote> quote;
+  };
+
+  const scheduler::size_type scheduler::stack_size
+    = PLORTH_GREEN_THREAD_STACK_SIZE;
+
+  scheduler& scheduler::current()
+  {
+    static thread_local scheduler instance;
+
+    return instance;
+  }
+
+  scheduler::scheduler()
+    : m_root(new task())
+    , m_current(m_root.get())
+    , m_waiting_count(0)
+    , m_size(0)
+    , m_joining(false)
+#if HAVE_SYS_EPOLL_H
+    , m_epoll(-1)
+#endif
+    {}
+
+  scheduler::~scheduler()
+  {
+    const auto root = m_root.get();
+
+    reap();
+    for (const auto task : m_ready)
+    {
+      if (task != root)
+      {
+        delete task;
+      }
+    }
+    for (const auto& entry : m_waiting)
+    {
+      for (const auto task : entry.second.readers)
+      {
+        if (task != root)
+        {
+          delete task;
+        }
+      }
+      for (const auto task : entry.second.writers)
+      {
+        if (task != root)
+        {
+          delete task;
+        }
+      }
+    }
+#if HAVE_SYS_EPOLL_H
+    if (m_epoll >= 0)
+    {
+      ::close(m_epoll);
+    }
+#endif
+  }
+
+  void scheduler::spawn(const std::shared_ptr<context>& ctx,
+                        const std::shared_ptr<class quote>& quote)
+  {
+    std::unique_ptr<task> new_task(new task());
+
+    new_task->context = context::make(ctx->runtime());
+    for (const auto& word : ctx->dictionary().words())
+    {
+      new_task->context->dictionary().insert(word);
+    }
+    new_task->quote = quote;
+    new_task->stack.reset(new char[stack_size]);
+    ::getcontext(&new_task->machine_context);
+    new_task->machine_context.uc_stack.ss_sp = new_task->stack.get();
+    new_task->machine_context.uc_stack.ss_size = stack_size;
+    new_task->machine_context.uc_link = nullptr;
+    ::makecontext(&new_task->machine_context, &scheduler::entry, 0);
+    m_ready.push_back(new_task.release());
+    ++m_size;
+  }
+
+  void scheduler::yield()
+  {
+    if (m_ready.empty() && !m_waiting_count)
+    {
+      return;
+    }
+    if (m_waiting_count > 0)
+    {
+      poll(0);
+    }
+    m_ready.push_back(m_current);
+    schedule();
+  }
+
+  bool scheduler::wait_readable(int fd)
+  {
+    return wait(fd, false);
+  }
+
+  bool scheduler::wait_writable(int fd)
+  {
+    return wait(fd, true);
+  }
+
+  void scheduler::join()
+  {
+    assert(m_current == m_root.get());
+
+    if (m_size > 0)
+    {
+      m_joining = true;
+      schedule();
+    }
+  }
+
+  void scheduler::entry()
+  {
+    auto& instance = current();
+    const auto task = instance.m_current;
+
+    instance.reap();
+    task->quote->call(task->context);
+
+    // Uncaught errors simply terminate the task. Release the values used by
+    // the task before switching away, as the task will never be resumed.
+    task->context.reset();
+    task->quote.reset();
+    instance.m_finished.push_back(task);
+    if (!--instance.m_size && instance.m_joining)
+    {
+      instance.m_joining = false;
+      instance.m_ready.push_back(instance.m_root.get());
+    }
+    instance.schedule();
+  }
+
+  void scheduler::schedule()
+  {
+    const auto previous = m_current;
+
+    // Root task is always either ready, waiting for input or waiting for the
+    // other tasks to complete, so some task can be waited for here.
+    while (m_ready.empty())
+    {
+      assert(m_waiting_count > 0);
+      poll(-1);
+    }
+    m_current = m_ready.front();
+    m_ready.pop_front();
+    if (m_current != previous)
+    {
+      ::swapcontext(&previous->machine_context, &m_current->machine_context);
+      reap();
+    }
+  }
+
+  bool scheduler::wait(int fd, bool writable)
+  {
+    // Nothing else to do while waiting, so let the caller block instead.
+    if (m_current == m_root.get() && !m_size)
+    {
+      return false;
+    }
+
+    auto& entry = m_waiting[fd];
+#if HAVE_SYS_EPOLL_H
+    const bool registered = !entry.readers.empty() || !entry.writers.empty();
+    struct epoll_event event;
+
+    event.events = 0;
+    if (writable || !entry.writers.empty())
+    {
+      event.events |= EPOLLOUT;
+    }
+    if (!writable || !entry.readers.empty())
+    {
+      event.events |= EPOLLIN;
+    }
+    event.data.fd = fd;
+
+    // File descriptors which cannot be polled, such as regular files, are
+    // always considered to be ready.
+    if ((m_epoll < 0 && (m_epoll = ::epoll_create1(EPOLL_CLOEXEC)) < 0)
+        || ::epoll_ctl(
+          m_epoll,
+          registered ? EPOLL_CTL_MOD : EPOLL_CTL_ADD,
+          fd,
+          &event
+        ) < 0)
+    {
+      if (!registered)
+      {
+        m_waiting.erase(fd);
+      }
+
+      return false;
+    }
+#endif
+    (writable ? entry.writers : entry.readers).push_back(m_current);
+    ++m_waiting_count;
+    schedule();
+
+    return true;
+  }
+
+  void scheduler::poll(int timeout)
+  {
+#if HAVE_SYS_EPOLL_H
+    struct epoll_event events[64];
+    const int count = ::epoll_wait(m_epoll, events, 64, timeout);
+
+    for (int i = 0; i < count; ++i)
+    {
+      // Errors and hang ups wake up both readers and writers, so that they
+      // can find out about them when retrying the operation.
+      const auto flags = events[i].events;
+      const bool failed = flags & (EPOLLERR | EPOLLHUP);
+
+      wake(
+        events[i].data.fd,
+        failed || (flags & EPOLLIN),
+        failed || (flags & EPOLLOUT)
+      );
+    }
+#else
+    std::vector<struct pollfd> fds;
+
+    fds.reserve(m_waiting.size());
+    for (const auto& entry : m_waiting)
+    {
+      struct pollfd fd;
+
+      fd.fd = entry.first;
+      fd.events = 0;
+      if (!entry.second.readers.empty())
+      {
+        fd.events |= POLLIN;
+      }
+      if (!entry.second.writers.empty())
+      {
+        fd.events |= POLLOUT;
+      }
+      fd.revents = 0;
+      fds.push_back(fd);
+    }
+    if (::poll(fds.data(), fds.size(), timeout) > 0)
+    {
+      for (const auto& fd : fds)
+      {
+        const bool failed = fd.revents & (POLLERR | POLLHUP | POLLNVAL);
+
+        if (fd.revents)
+        {
+          wake(
+            fd.fd,
+            failed || (fd.revents & POLLIN),
+            failed || (fd.revents & POLLOUT)
+          );
+        }
+      }
+    }
+#endif
+  }
+
+  void scheduler::wake(int fd, bool readable, bool writable)
+  {
+    const auto entry = m_waiting.find(fd);
+
+    if (entry == std::end(m_waiting))
+    {
+      return;
+    }
+
+    auto& readers = entry->second.readers;
+    auto& writers = entry->second.writers;
+
+    if (readable)
+    {
+      m_ready.insert(std::end(m_ready), std::begin(readers), std::end(readers));
+      m_waiting_count -= readers.size();
+      readers.clear();
+    }
+    if (writable)
+    {
+      m_ready.insert(std::end(m_ready), std::begin(writers), std::end(writers));
+      m_waiting_count -= writers.size();
+      writers.clear();
+    }
+    if (readers.empty() && writers.empty())
+    {
+      m_waiting.erase(entry);
+#if HAVE_SYS_EPOLL_H
+      ::epoll_ctl(m_epoll, EPOLL_CTL_DEL, fd, nullptr);
+#endif
+    }
+#if HAVE_SYS_EPOLL_H
+    else
+    {
+      struct epoll_event event;
+
+      event.events = readers.empty() ? EPOLLOUT : EPOLLIN;
+      event.data.fd = fd;
+      ::epoll_ctl(m_epoll, EPOLL_CTL_MOD, fd, &event);
+    }
+#endif
+  }
+
+  void scheduler::reap()
+  {
+    for (const auto task : m_finished)
+    {
+      delete task;
+    }
+    m_finished.clear();
+  }
+}
+#endif
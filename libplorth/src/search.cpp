@@ -0,0 +1,354 @@
+/*
+ * Copyright (c) 2017-2018, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "./search.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+
+#if defined(__SSE2__)
+# include <emmintrin.h>
+#endif
+
+/**
+ * Needles shorter than this are searched by scanning for their first
+ * character and comparing the rest, which is faster than setting up the
+ * Two-Way algorithm.
+ */
+#if !defined(PLORTH_SEARCH_SHORT_NEEDLE)
+# define PLORTH_SEARCH_SHORT_NEEDLE 8
+#endif
+
+namespace plorth
+{
+  namespace search
+  {
+    namespace
+    {
+      template<class It>
+      static std::size_t find_char(It haystack,
+                                   std::size_t length,
+                                   char32_t c)
+      {
+        for (std::size_t i = 0; i < length; ++i)
+        {
+          if (haystack[i] == c)
+          {
+            return i;
+          }
+        }
+
+        return npos;
+      }
+
+      /**
+       * Forward search for single character, which compares four characters
+       * at once when SSE2 instructions are available.
+       */
+      static std::size_t find_char(const char32_t* haystack,
+                                   std::size_t length,
+                                   char32_t c)
+      {
+        std::size_t i = 0;
+
+#if defined(__SSE2__)
+        const auto pattern = _mm_set1_epi32(static_cast<int>(c));
+
+        for (; i + 4 <= length; i += 4)
+        {
+          const auto mask = _mm_movemask_epi8(_mm_cmpeq_epi32(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + i)),
+            pattern
+          ));
+
+          if (mask)
+          {
+            for (std::size_t j = 0; j < 4; ++j)
+            {
+              if (mask & (1 << (j * 4)))
+              {
+                return i + j;
+              }
+            }
+          }
+        }
+#endif
+        for (; i < length; ++i)
+        {
+          if (haystack[i] == c)
+          {
+            return i;
+          }
+        }
+
+        return npos;
+      }
+
+      /**
+       * Scans for the first character of the needle and compares rest of the
+       * characters at each candidate position.
+       */
+      template<class It>
+      static std::size_t find_short(It haystack,
+                                    std::size_t haystack_length,
+                                    It needle,
+                                    std::size_t needle_length)
+      {
+        const auto last = haystack_length - needle_length;
+
+        for (std::size_t position = 0; position <= last;)
+        {
+          const auto index = find_char(
+            haystack + position,
+            last - position + 1,
+            needle[0]
+          );
+
+          if (index == npos)
+          {
+            break;
+          }
+          position += index;
+          if (std::equal(needle + 1,
+                         needle + needle_length,
+                         haystack + position + 1))
+          {
+            return position;
+          }
+          ++position;
+        }
+
+        return npos;
+      }
+
+      /**
+       * Two-Way string matching algorithm by Crochemore and Perrin, which
+       * runs in linear time and constant space. Bad character shifts are
+       * computed from the lowest eight bits of each character, which keeps
+       * them conservative for the whole Unicode range.
+       */
+      template<class It>
+      static std::size_t find_two_way(It haystack,
+                                      std::size_t haystack_length,
+                                      It needle,
+                                      std::size_t needle_length)
+      {
+        const auto l = needle_length;
+        std::uint64_t set[4] = { 0, 0, 0, 0 };
+        std::size_t shift[256];
+        std::size_t ip;
+        std::size_t jp;
+        std::size_t k;
+        std::size_t p;
+        std::size_t ms;
+        std::size_t p0;
+        std::size_t mem;
+        std::size_t mem0;
+        std::size_t position;
+
+        for (std::size_t i = 0; i < l; ++i)
+        {
+          const auto b = needle[i] & 0xff;
+
+          set[b >> 6] |= UINT64_C(1) << (b & 63);
+          shift[b] = i + 1;
+        }
+
+        // Compute maximal suffix.
+        ip = static_cast<std::size_t>(-1);
+        jp = 0;
+        k = p = 1;
+        while (jp + k < l)
+        {
+          if (needle[ip + k] == needle[jp + k])
+          {
+            if (k == p)
+            {
+              jp += p;
+              k = 1;
+            } else {
+              ++k;
+            }
+          }
+          else if (needle[ip + k] > needle[jp + k])
+          {
+            jp += k;
+            k = 1;
+            p = jp - ip;
+          } else {
+            ip = jp++;
+            k = p = 1;
+          }
+        }
+        ms = ip;
+        p0 = p;
+
+        // And with the opposite comparison.
+        ip = static_cast<std::size_t>(-1);
+        jp = 0;
+        k = p = 1;
+        while (jp + k < l)
+        {
+          if (needle[ip + k] == needle[jp + k])
+          {
+            if (k == p)
+            {
+              jp += p;
+              k = 1;
+            } else {
+              ++k;
+            }
+          }
+          else if (needle[ip + k] < needle[jp + k])
+          {
+            jp += k;
+            k = 1;
+            p = jp - ip;
+          } else {
+            ip = jp++;
+            k = p = 1;
+          }
+        }
+        if (ip + 1 > ms + 1)
+        {
+          ms = ip;
+        } else {
+          p = p0;
+        }
+
+        // Periodic needle?
+        if (!std::equal(needle, needle + ms + 1, needle + p))
+        {
+          mem0 = 0;
+          p = std::max(ms, l - ms - 1) + 1;
+        } else {
+          mem0 = l - p;
+        }
+        mem = 0;
+
+        for (position = 0; haystack_length - position >= l;)
+        {
+          const auto b = haystack[position + l - 1] & 0xff;
+
+          // Check the last character first and advance by shift on mismatch.
+          if (set[b >> 6] & (UINT64_C(1) << (b & 63)))
+          {
+            k = l - shift[b];
+            if (k)
+            {
+              position += std::max(k, mem);
+              mem = 0;
+              continue;
+            }
+          } else {
+            position += l;
+            mem = 0;
+            continue;
+          }
+
+          // Compare right half.
+          for (k = std::max(ms + 1, mem);
+               k < l && needle[k] == haystack[position + k];
+               ++k);
+          if (k < l)
+          {
+            position += k - ms;
+            mem = 0;
+            continue;
+          }
+
+          // Compare left half.
+          for (k = ms + 1;
+               k > mem && needle[k - 1] == haystack[position + k - 1];
+               --k);
+          if (k <= mem)
+          {
+            return position;
+          }
+          position += p;
+          mem = mem0;
+        }
+
+        return npos;
+      }
+
+      template<class It>
+      static std::size_t find_any(It haystack,
+                                  std::size_t haystack_length,
+                                  It needle,
+                                  std::size_t needle_length)
+      {
+        if (!needle_length)
+        {
+          return 0;
+        }
+        else if (needle_length > haystack_length)
+        {
+          return npos;
+        }
+        else if (needle_length == 1)
+        {
+          return find_char(haystack, haystack_length, needle[0]);
+        }
+        else if (needle_length < PLORTH_SEARCH_SHORT_NEEDLE)
+        {
+          return find_short(haystack, haystack_length, needle, needle_length);
+        }
+
+        return find_two_way(haystack, haystack_length, needle, needle_length);
+      }
+    }
+
+    std::size_t find(const char32_t* haystack,
+                     std::size_t haystack_length,
+                     const char32_t* needle,
+                     std::size_t needle_length)
+    {
+      return find_any(haystack, haystack_length, needle, needle_length);
+    }
+
+    std::size_t find_last(const char32_t* haystack,
+                          std::size_t haystack_length,
+                          const char32_t* needle,
+                          std::size_t needle_length)
+    {
+      using reverse_iterator = std::reverse_iterator<const char32_t*>;
+      std::size_t index;
+
+      // Search for reversed needle from the reversed haystack.
+      index = find_any(
+        reverse_iterator(haystack + haystack_length),
+        haystack_length,
+        reverse_iterator(needle + needle_length),
+        needle_length
+      );
+
+      return index == npos
+        ? npos
+        : haystack_length - index - needle_length;
+    }
+  }
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2017-2018, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PLORTH_SEARCH_HPP_GUARD
+#define PLORTH_SEARCH_HPP_GUARD
+
+#include <cstddef>
+#include <limits>
+
+namespace plorth
+{
+  namespace search
+  {
+    /** Returned when no match was found. */
+    static const std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    /**
+     * Searches for the first occurrence of needle from the haystack, in time
+     * linear to the length of the haystack.
+     *
+     * \param haystack        Characters to search from.
+     * \param haystack_length Number of characters in the haystack.
+     * \param needle          Characters to search for.
+     * \param needle_length   Number of characters in the needle.
+     * \return                Offset of the first occurrence, or npos if the
+     *                        needle does not occur in the haystack.
+     */
+    std::size_t find(const char32_t* haystack,
+                     std::size_t haystack_length,
+                     const char32_t* needle,
+                     std::size_t needle_length);
+
+    /**
+     * Searches for the last occurrence of needle from the haystack, in time
+     * linear to the length of the haystack.
+     *
+     * \param haystack        Characters to search from.
+     * \param haystack_length Number of characters in the haystack.
+     * \param needle          Characters to search for.
+     * \param needle_length   Number of characters in the needle.
+     * \return                Offset of the last occurrence, or npos if the
+     *                        needle does not occur in the haystack.
+     */
+    std::size_t find_last(const char32_t* haystack,
+                          std::size_t haystack_length,
+                          const char32_t* needle,
+                          std::size_t needle_length);
+  }
+}
+
+#endif /* !PLORTH_SEARCH_HPP_GUARD */
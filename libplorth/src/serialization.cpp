@@ -0,0 +1,520 @@
+/*
+ * Copyright (c) 2017-2018, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <plorth/unicode.hpp>
+#include <plorth/value-word.hpp>
+
+#include "./serialization.hpp"
+#include "./utils.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace plorth
+{
+  namespace serialization
+  {
+    /** Maximum nesting level of values accepted by the reader. */
+    static const unsigned int max_depth = 1024;
+
+    /**
+     * Enumeration of tags used for identifying different types of values.
+     */
+    enum class tag
+    {
+      null = 0,
+      boolean_true = 1,
+      boolean_false = 2,
+      integer = 3,
+      real = 4,
+      string = 5,
+      array = 6,
+      object = 7,
+      symbol = 8,
+      symbol_with_position = 9,
+      word = 10,
+      quote = 11
+    };
+
+    writer::writer(std::string& output)
+      : m_output(output) {}
+
+    void writer::write_uint(std::uint64_t value)
+    {
+      while (value >= 0x80)
+      {
+        m_output.append(1, static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+      }
+      m_output.append(1, static_cast<char>(value));
+    }
+
+    void writer::write_string(const std::u32string& value)
+    {
+      const auto encoded = utf8_encode(value);
+
+      write_uint(encoded.length());
+      m_output.append(encoded);
+    }
+
+    void writer::write_bytes(const char* bytes, std::size_t length)
+    {
+      m_output.append(bytes, length);
+    }
+
+    bool writer::write_value(const std::shared_ptr<value>& value)
+    {
+      if (!value)
+      {
+        write_uint(static_cast<std::uint64_t>(tag::null));
+
+        return true;
+      }
+
+      switch (value->type())
+      {
+        case value::type::null:
+          write_uint(static_cast<std::uint64_t>(tag::null));
+          break;
+
+        case value::type::boolean:
+          write_uint(static_cast<std::uint64_t>(
+            std::static_pointer_cast<boolean>(value)->value()
+              ? tag::boolean_true
+              : tag::boolean_false
+          ));
+          break;
+
+        case value::type::number:
+          {
+            const auto num = std::static_pointer_cast<number>(value);
+
+            if (num->is(number::number_type::integer))
+            {
+              const auto i = static_cast<std::int64_t>(num->as_int());
+
+              // Use zigzag encoding so that small negative numbers remain
+              // small.
+              write_uint(static_cast<std::uint64_t>(tag::integer));
+              write_uint(
+                (static_cast<std::uint64_t>(i) << 1) ^
+                static_cast<std::uint64_t>(i >> 63)
+              );
+            } else {
+              const number::real_type r = num->as_real();
+              std::uint64_t bits;
+
+              static_assert(sizeof(r) == sizeof(bits), "Unsupported double.");
+              std::memcpy(&bits, &r, sizeof(bits));
+              write_uint(static_cast<std::uint64_t>(tag::real));
+              for (int i = 0; i < 8; ++i)
+              {
+                m_output.append(1, static_cast<char>((bits >> (i * 8)) & 0xff));
+              }
+            }
+          }
+          break;
+
+        case value::type::string:
+          write_uint(static_cast<std::uint64_t>(tag::string));
+          write_string(value->to_string());
+          break;
+
+        case value::type::array:
+          {
+            const auto ary = std::static_pointer_cast<array>(value);
+            const auto size = ary->size();
+
+            write_uint(static_cast<std::uint64_t>(tag::array));
+            write_uint(size);
+            for (array::size_type i = 0; i < size; ++i)
+            {
+              if (!write_value(ary->at(i)))
+              {
+                return false;
+              }
+            }
+          }
+          break;
+
+        case value::type::object:
+          {
+            const auto entries = std::static_pointer_cast<object>(
+              value
+            )->entries();
+
+            write_uint(static_cast<std::uint64_t>(tag::object));
+            write_uint(entries.size());
+            for (const auto& entry : entries)
+            {
+              write_string(entry.first);
+              if (!write_value(entry.second))
+              {
+                return false;
+              }
+            }
+          }
+          break;
+
+        case value::type::symbol:
+          {
+            const auto sym = std::static_pointer_cast<symbol>(value);
+            const auto position = sym->position();
+
+            if (!position)
+            {
+              write_uint(static_cast<std::uint64_t>(tag::symbol));
+              write_string(sym->id());
+              break;
+            }
+
+            write_uint(static_cast<std::uint64_t>(tag::symbol_with_position));
+            write_string(sym->id());
+
+            // Filenames are written only once and referred to by their index
+            // after that.
+            const auto entry = m_filenames.find(position->filename);
+
+            if (entry != std::end(m_filenames))
+            {
+              write_uint(entry->second);
+            } else {
+              const auto index = m_filenames.size();
+
+              write_uint(index);
+              write_string(position->filename);
+              m_filenames[position->filename] = index;
+            }
+            write_uint(static_cast<std::uint64_t>(std::max(position->line, 0)));
+            write_uint(static_cast<std::uint64_t>(std::max(position->column, 0)));
+          }
+          break;
+
+        case value::type::word:
+          {
+            const auto wrd = std::static_pointer_cast<word>(value);
+
+            write_uint(static_cast<std::uint64_t>(tag::word));
+
+            return write_value(wrd->symbol()) && write_value(wrd->quote());
+          }
+
+        case value::type::quote:
+          {
+            const auto values = compiled_quote_values(
+              std::static_pointer_cast<quote>(value)
+            );
+
+            // Native quotes cannot be serialized.
+            if (!values)
+            {
+              return false;
+            }
+            write_uint(static_cast<std::uint64_t>(tag::quote));
+            write_uint(values->size());
+            for (const auto& child : *values)
+            {
+              if (!write_value(child))
+              {
+                return false;
+              }
+            }
+          }
+          break;
+
+        default:
+          return false;
+      }
+
+      return true;
+    }
+
+    reader::reader(const std::shared_ptr<class runtime>& runtime,
+                   const char* input,
+                   std::size_t length)
+      : m_runtime(runtime)
+      , m_input(input)
+      , m_length(length)
+      , m_offset(0) {}
+
+    bool reader::read_uint(std::uint64_t& slot)
+    {
+      unsigned int shift = 0;
+
+      slot = 0;
+      while (m_offset < m_length && shift < 64)
+      {
+        const auto byte = static_cast<unsigned char>(m_input[m_offset++]);
+
+        slot |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+        {
+          return true;
+        }
+        shift += 7;
+      }
+
+      return false;
+    }
+
+    bool reader::read_string(std::u32string& slot)
+    {
+      std::uint64_t length;
+
+      if (!read_uint(length) || length > m_length - m_offset)
+      {
+        return false;
+      }
+      if (!utf8_decode_test(std::string(m_input + m_offset, length), slot))
+      {
+        return false;
+      }
+      m_offset += length;
+
+      return true;
+    }
+
+    bool reader::expect_bytes(const char* bytes, std::size_t length)
+    {
+      if (length > m_length - m_offset
+          || std::memcmp(m_input + m_offset, bytes, length))
+      {
+        return false;
+      }
+      m_offset += length;
+
+      return true;
+    }
+
+    bool reader::read_value(std::shared_ptr<value>& slot)
+    {
+      return read_value(slot, 0);
+    }
+
+    bool reader::read_value(std::shared_ptr<value>& slot, unsigned int depth)
+    {
+      std::uint64_t t;
+      std::uint64_t size;
+
+      if (depth > max_depth || !read_uint(t))
+      {
+        return false;
+      }
+
+      switch (static_cast<tag>(t))
+      {
+        case tag::null:
+          slot.reset();
+          break;
+
+        case tag::boolean_true:
+        case tag::boolean_false:
+          slot = m_runtime->boolean(static_cast<tag>(t) == tag::boolean_true);
+          break;
+
+        case tag::integer:
+          {
+            std::uint64_t encoded;
+
+            if (!read_uint(encoded))
+            {
+              return false;
+            }
+            slot = m_runtime->number(static_cast<number::int_type>(
+              static_cast<std::int64_t>(encoded >> 1) ^
+              -static_cast<std::int64_t>(encoded & 1)
+            ));
+          }
+          break;
+
+        case tag::real:
+          {
+            std::uint64_t bits = 0;
+            number::real_type r;
+
+            if (m_length - m_offset < 8)
+            {
+              return false;
+            }
+            for (int i = 0; i < 8; ++i)
+            {
+              bits |= static_cast<std::uint64_t>(
+                static_cast<unsigned char>(m_input[m_offset++])
+              ) << (i * 8);
+            }
+            std::memcpy(&r, &bits, sizeof(r));
+            slot = m_runtime->number(r);
+          }
+          break;
+
+        case tag::string:
+          {
+            std::u32string str;
+
+            if (!read_string(str))
+            {
+              return false;
+            }
+            slot = m_runtime->string(str);
+          }
+          break;
+
+        case tag::array:
+          {
+            std::vector<std::shared_ptr<value>> elements;
+
+            if (!read_uint(size) || size > m_length - m_offset)
+            {
+              return false;
+            }
+            elements.resize(size);
+            for (auto& element : elements)
+            {
+              if (!read_value(element, depth + 1))
+              {
+                return false;
+              }
+            }
+            slot = m_runtime->array(elements.data(), elements.size());
+          }
+          break;
+
+        case tag::object:
+          {
+            std::vector<object::value_type> properties;
+
+            if (!read_uint(size) || size > m_length - m_offset)
+            {
+              return false;
+            }
+            properties.resize(size);
+            for (auto& property : properties)
+            {
+              if (!read_string(property.first)
+                  || !read_value(property.second, depth + 1))
+              {
+                return false;
+              }
+            }
+            slot = m_runtime->object(properties);
+          }
+          break;
+
+        case tag::symbol:
+          {
+            std::u32string id;
+
+            if (!read_string(id))
+            {
+              return false;
+            }
+            slot = m_runtime->symbol(id);
+          }
+          break;
+
+        case tag::symbol_with_position:
+          {
+            std::u32string id;
+            std::uint64_t index;
+            std::uint64_t line;
+            std::uint64_t column;
+            struct position position;
+
+            if (!read_string(id) || !read_uint(index))
+            {
+              return false;
+            }
+            if (index == m_filenames.size())
+            {
+              std::u32string filename;
+
+              if (!read_string(filename))
+              {
+                return false;
+              }
+              m_filenames.push_back(filename);
+            }
+            else if (index > m_filenames.size())
+            {
+              return false;
+            }
+            if (!read_uint(line) || !read_uint(column))
+            {
+              return false;
+            }
+            position.filename = m_filenames[index];
+            position.line = static_cast<int>(line);
+            position.column = static_cast<int>(column);
+            slot = m_runtime->symbol(id, &position);
+          }
+          break;
+
+        case tag::word:
+          {
+            std::shared_ptr<value> sym;
+            std::shared_ptr<value> quo;
+
+            if (!read_value(sym, depth + 1)
+                || !value::is(sym, value::type::symbol)
+                || !read_value(quo, depth + 1)
+                || !value::is(quo, value::type::quote))
+            {
+              return false;
+            }
+            slot = m_runtime->word(
+              std::static_pointer_cast<symbol>(sym),
+              std::static_pointer_cast<quote>(quo)
+            );
+          }
+          break;
+
+        case tag::quote:
+          {
+            std::vector<std::shared_ptr<value>> values;
+
+            if (!read_uint(size) || size > m_length - m_offset)
+            {
+              return false;
+            }
+            values.resize(size);
+            for (auto& child : values)
+            {
+              if (!read_value(child, depth + 1))
+              {
+                return false;
+              }
+            }
+            slot = m_runtime->compiled_quote(values);
+          }
+          break;
+
+        default:
+          return false;
+      }
+
+      return true;
+    }
+  }
+}
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2017-2018, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PLORTH_SERIALIZATION_HPP_GUARD
+#define PLORTH_SERIALIZATION_HPP_GUARD
+
+#include <plorth/context.hpp>
+
+#include <cstdint>
+#include <unordered_map>
+
+namespace plorth
+{
+  namespace serialization
+  {
+    /**
+     * Serializes values into compact binary form, which can be stored into
+     * a file and later loaded back without having to parse and compile the
+     * source code again. Only values which can be produced by the compiler
+     * are supported; native quotes and errors cannot be serialized.
+     */
+    class writer
+    {
+    public:
+      explicit writer(std::string& output);
+
+      /**
+       * Writes unsigned integer in variable length encoding.
+       */
+      void write_uint(std::uint64_t value);
+
+      /**
+       * Writes string encoded in UTF-8, prefixed by it's length.
+       */
+      void write_string(const std::u32string& value);
+
+      /**
+       * Writes raw bytes without any kind of length prefix.
+       */
+      void write_bytes(const char* bytes, std::size_t length);
+
+      /**
+       * Writes given value, including all the values it contains.
+       *
+       * \param value Value to serialize.
+       * \return      Boolean flag telling whether the value could be
+       *              serialized or not.
+       */
+      bool write_value(const std::shared_ptr<value>& value);
+
+      writer(const writer&) = delete;
+      writer(writer&&) = delete;
+      void operator=(const writer&) = delete;
+      void operator=(writer&&) = delete;
+
+    private:
+      /** Where the serialized data is written into. */
+      std::string& m_output;
+      /** Indexes of source code filenames already written. */
+      std::unordered_map<std::u32string, std::uint64_t> m_filenames;
+    };
+
+    /**
+     * Reads values serialized with the writer back into runtime.
+     */
+    class reader
+    {
+    public:
+      explicit reader(const std::shared_ptr<class runtime>& runtime,
+                      const char* input,
+                      std::size_t length);
+
+      /**
+       * Returns true if all of the input has been read.
+       */
+      inline bool eof() const
+      {
+        return m_offset >= m_length;
+      }
+
+      bool read_uint(std::uint64_t& slot);
+
+      bool read_string(std::u32string& slot);
+
+      /**
+       * Reads given number of raw bytes and tests whether they match with
+       * the given ones.
+       */
+      bool expect_bytes(const char* bytes, std::size_t length);
+
+      /**
+       * Reads single value, including all the values it contains.
+       *
+       * \param slot Where the value will be placed into.
+       * \return     Boolean flag telling whether the value could be read, or
+       *             whether the input was malformed.
+       */
+      bool read_value(std::shared_ptr<value>& slot);
+
+      reader(const reader&) = delete;
+      reader(reader&&) = delete;
+      void operator=(const reader&) = delete;
+      void operator=(reader&&) = delete;
+
+    private:
+      bool read_value(std::shared_ptr<value>& slot, unsigned int depth);
+
+    private:
+      /** Runtime used for constructing the values. */
+      const std::shared_ptr<class runtime> m_runtime;
+      /** Input being read. */
+      const char* m_input;
+      /** Length of the input. */
+      const std::size_t m_length;
+      /** Current offset in the input. */
+      std::size_t m_offset;
+      /** Source code filenames already read. */
+      std::vector<std::u32string> m_filenames;
+    };
+  }
+}
+
+#endif /* !PLORTH_SERIALIZATION_HPP_GUARD */
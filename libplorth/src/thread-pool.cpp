@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2017-2018, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "./thread-pool.hpp"
+
+#if PLORTH_ENABLE_THREADS
+# include <atomic>
+# include <condition_variable>
+# include <cstdint>
+# include <cstdlib>
+# include <mutex>
+# include <thread>
+# include <vector>
+#endif
+
+namespace plorth
+{
+  namespace thread_pool
+  {
+#if PLORTH_ENABLE_THREADS
+    namespace
+    {
+      /**
+       * Fixed set of worker threads which wait for tasks to be executed. Only
+       * one batch of tasks is executed at a time.
+       */
+      class pool
+      {
+      public:
+        using task_type = std::function<void(std::size_t)>;
+
+        pool()
+          : m_busy(false)
+          , m_task(nullptr)
+          , m_count(0)
+          , m_next(0)
+          , m_generation(0)
+          , m_pending(0)
+          , m_shutdown(false)
+        {
+          auto concurrency = std::thread::hardware_concurrency();
+
+          // Number of threads can be overridden with an environment variable.
+          if (const auto value = std::getenv("PLORTH_THREADS"))
+          {
+            const auto threads = std::atoi(value);
+
+            if (threads > 0)
+            {
+              concurrency = static_cast<unsigned int>(threads);
+            }
+          }
+
+          for (unsigned int i = 1; i < concurrency; ++i)
+          {
+            m_workers.emplace_back(&pool::work, this);
+          }
+        }
+
+        ~pool()
+        {
+          {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            m_shutdown = true;
+          }
+          m_wake.notify_all();
+          for (auto& worker : m_workers)
+          {
+            worker.join();
+          }
+        }
+
+        inline std::size_t concurrency() const
+        {
+          return m_workers.size() + 1;
+        }
+
+        bool run(std::size_t count, const task_type& task)
+        {
+          bool expected = false;
+
+          if (m_workers.empty()
+              || !m_busy.compare_exchange_strong(expected, true))
+          {
+            return false;
+          }
+
+          {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            m_task = &task;
+            m_count = count;
+            m_next = 0;
+            m_pending = m_workers.size();
+            ++m_generation;
+          }
+          m_wake.notify_all();
+
+          // The calling thread participates in executing the tasks instead
+          // of just waiting for the workers to complete them.
+          execute();
+
+          {
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            m_done.wait(lock, [this] { return !m_pending; });
+            m_task = nullptr;
+          }
+          m_busy = false;
+
+          return true;
+        }
+
+      private:
+        void execute()
+        {
+          for (;;)
+          {
+            const auto index = m_next.fetch_add(1);
+
+            if (index >= m_count)
+            {
+              break;
+            }
+            (*m_task)(index);
+          }
+        }
+
+        void work()
+        {
+          std::uint64_t generation = 0;
+
+          for (;;)
+          {
+            {
+              std::unique_lock<std::mutex> lock(m_mutex);
+
+              m_wake.wait(lock, [this, generation]
+              {
+                return m_shutdown || m_generation != generation;
+              });
+              if (m_shutdown)
+              {
+                return;
+              }
+              generation = m_generation;
+            }
+
+            execute();
+
+            {
+              std::lock_guard<std::mutex> lock(m_mutex);
+
+              if (!--m_pending)
+              {
+                m_done.notify_one();
+              }
+            }
+          }
+        }
+
+      private:
+        /** Whether a batch of tasks is currently being executed. */
+        std::atomic<bool> m_busy;
+        /** Callback of the batch currently being executed. */
+        const task_type* m_task;
+        /** Number of tasks in the batch currently being executed. */
+        std::size_t m_count;
+        /** Index of the next task to execute. */
+        std::atomic<std::size_t> m_next;
+        /** Incremented each time a new batch is started. */
+        std::uint64_t m_generation;
+        /** Number of workers still working on the current batch. */
+        std::size_t m_pending;
+        /** Whether the worker threads should terminate. */
+        bool m_shutdown;
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_done;
+        std::vector<std::thread> m_workers;
+      };
+
+      static pool& instance()
+      {
+        static pool instance;
+
+        return instance;
+      }
+    }
+#endif
+
+    std::size_t concurrency()
+    {
+#if PLORTH_ENABLE_THREADS
+      return instance().concurrency();
+#else
+      return 1;
+#endif
+    }
+
+    void run(std::size_t count, const std::function<void(std::size_t)>& task)
+    {
+#if PLORTH_ENABLE_THREADS
+      if (count > 1 && instance().run(count, task))
+      {
+        return;
+      }
+#endif
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        task(i);
+      }
+    }
+  }
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2017-2018, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PLORTH_THREAD_POOL_HPP_GUARD
+#define PLORTH_THREAD_POOL_HPP_GUARD
+
+#include <plorth/config.hpp>
+
+#include <cstddef>
+#include <functional>
+
+namespace plorth
+{
+  namespace thread_pool
+  {
+    /**
+     * Returns the number of threads which can execute tasks simultaneously,
+     * including the calling thread. Returns 1 if threads have been disabled.
+     */
+    std::size_t concurrency();
+
+    /**
+     * Executes given task once for each index between zero and count, using
+     * worker threads of the process wide thread pool as well as the calling
+     * thread. Returns once all of the tasks have been completed.
+     *
+     * If the thread pool is already busy, for example when this function is
+     * called from within a task, the tasks are executed serially by the
+     * calling thread instead.
+     *
+     * \param count Number of tasks to execute.
+     * \param task  Callback which is given index of the task to execute.
+     */
+    void run(std::size_t count, const std::function<void(std::size_t)>& task);
+  }
+}
+
+#endif /* !PLORTH_THREAD_POOL_HPP_GUARD */
@@ -49,63 +49,83 @@ namespace plorth
     std::u32string result;
 
     result.reserve(input.length() + 2);
-    result.append(1, '"');
+    json_stringify(input, result);
 
-    for (const auto& c : input)
+    return result;
+  }
+
+  void json_stringify(const std::u32string& input, std::u32string& output)
+  {
+    const auto length = input.length();
+    std::u32string::size_type run = 0;
+
+    output.append(1, '"');
+
+    for (std::u32string::size_type i = 0; i < length; ++i)
     {
+      const auto c = input[i];
+
+      // Characters which do not have to be escaped are copied in runs.
+      if (c >= 0x20 && c != '"' && c != '\\' && c != '/' && c < 0x7f)
+      {
+        continue;
+      }
+      else if (c >= 0x7f && !unicode_iscntrl(c))
+      {
+        continue;
+      }
+      output.append(input, run, i - run);
+      run = i + 1;
+
       switch (c)
       {
         case 010:
-          result.append(1, '\\');
-          result.append(1, 'b');
+          output.append(1, '\\');
+          output.append(1, 'b');
           break;
 
         case 011:
-          result.append(1, '\\');
-          result.append(1, 't');
+          output.append(1, '\\');
+          output.append(1, 't');
           break;
 
         case 012:
-          result.append(1, '\\');
-          result.append(1, 'n');
+          output.append(1, '\\');
+          output.append(1, 'n');
           break;
 
         case 014:
-          result.append(1, '\\');
-          result.append(1, 'f');
+          output.append(1, '\\');
+          output.append(1, 'f');
           break;
 
         case 015:
-          result.append(1, '\\');
-          result.append(1, 'r');
+          output.append(1, '\\');
+          output.append(1, 'r');
           break;
 
         case '"':
         case '\\':
         case '/':
-          result.append(1, '\\');
-          result.append(1, c);
+          output.append(1, '\\');
+          output.append(1, c);
           break;
 
         default:
-          if (unicode_iscntrl(c))
           {
             char buffer[7];
 
             std::snprintf(buffer, 7, "\\u%04x", c);
             for (const char* p = buffer; *p; ++p)
             {
-              result.append(1, static_cast<char32_t>(*p));
+              output.append(1, static_cast<char32_t>(*p));
             }
-          } else {
-            result.append(1, c);
           }
       }
     }
+    output.append(input, run, length - run);
 
-    result.append(1, '"');
-
-    return result;
+    output.append(1, '"');
   }
 
   bool is_number(const std::u32string& input)
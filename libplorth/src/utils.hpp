@@ -28,14 +28,85 @@
 
 #include <plorth/value-number.hpp>
 
+#include <vector>
+
 namespace plorth
 {
+  class context;
+  class quote;
+  class symbol;
+
   std::u32string json_stringify(const std::u32string&);
+  void json_stringify(const std::u32string&, std::u32string&);
   number::int_type to_integer(const std::u32string&);
   number::real_type to_real(const std::u32string&);
   bool is_number(const std::u32string&);
   std::u32string to_unistring(number::int_type);
   std::u32string to_unistring(number::real_type);
+
+  /**
+   * Stores given number into the slot. If the slot contains number which is
+   * not referenced from anywhere else, it's updated in place instead of
+   * allocating new one.
+   */
+  void number_store(const std::shared_ptr<runtime>&,
+                    std::shared_ptr<value>&,
+                    number::int_type);
+  void number_store(const std::shared_ptr<runtime>&,
+                    std::shared_ptr<value>&,
+                    number::real_type);
+
+  /**
+   * Arithmetic operations which store their result into the slot given as
+   * the second argument. The slot may hold one of the operands.
+   */
+  void number_add(const std::shared_ptr<runtime>&,
+                  std::shared_ptr<value>&,
+                  const number&,
+                  const number&);
+  void number_sub(const std::shared_ptr<runtime>&,
+                  std::shared_ptr<value>&,
+                  const number&,
+                  const number&);
+  void number_mul(const std::shared_ptr<runtime>&,
+                  std::shared_ptr<value>&,
+                  const number&,
+                  const number&);
+  void number_div(const std::shared_ptr<runtime>&,
+                  std::shared_ptr<value>&,
+                  const number&,
+                  const number&);
+  void number_mod(const std::shared_ptr<runtime>&,
+                  std::shared_ptr<value>&,
+                  const number&,
+                  const number&);
+
+  bool number_lt(const number&, const number&);
+  bool number_gt(const number&, const number&);
+  bool number_lte(const number&, const number&);
+  bool number_gte(const number&, const number&);
+
+  /**
+   * Returns the values of given compiled quote, or null pointer if the quote
+   * is not a compiled one.
+   */
+  const std::vector<std::shared_ptr<value>>* compiled_quote_values(
+    const std::shared_ptr<quote>& quote
+  );
+
+  /**
+   * Executes given symbol, except when the symbol resolves into a quote, in
+   * which case the quote is returned to the caller instead of being called.
+   *
+   * \param ctx    Execution context.
+   * \param sym    Symbol to execute.
+   * \param callee Where the quote to be called is stored into.
+   * \return       Boolean flag telling whether the execution was successful
+   *               or not.
+   */
+  bool resolve_symbol(const std::shared_ptr<context>& ctx,
+                      const std::shared_ptr<symbol>& sym,
+                      std::shared_ptr<quote>& callee);
 }
 
 #endif /* !PLORTH_UTILS_HPP_GUARD */
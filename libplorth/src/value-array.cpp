@@ -25,32 +25,40 @@
  */
 #include <plorth/context.hpp>
 
+#include "./thread-pool.hpp"
+
+#include <algorithm>
+
+#if !defined(PLORTH_PARALLEL_GRAIN_SIZE)
+# define PLORTH_PARALLEL_GRAIN_SIZE 64
+#endif
+
 namespace plorth
 {
   namespace
   {
     /**
-     * Implementation of simple array, which only acts as a wrapper for C type
-     * array.
+     * Implementation of array where the elements are stored inline after the
+     * array object itself, in the same memory slot.
      */
     class simple_array : public array
     {
     public:
-      simple_array(size_type size, const_pointer elements)
+      simple_array(size_type size, const_pointer elements, void** payload)
         : m_size(size)
-        , m_elements(size > 0 ? new value_type[size] : nullptr)
+        , m_elements(static_cast<pointer>(*payload))
       {
         for (size_type i = 0; i < m_size; ++i)
         {
-          m_elements[i] = elements[i];
+          new (static_cast<void*>(m_elements + i)) value_type(elements[i]);
         }
       }
 
       ~simple_array()
       {
-        if (m_size > 0)
+        for (size_type i = 0; i < m_size; ++i)
         {
-          delete[] m_elements;
+          m_elements[i].~value_type();
         }
       }
 
@@ -322,8 +330,22 @@ namespace plorth
   std::shared_ptr<class array> runtime::array(array::const_pointer elements,
                                               array::size_type size)
   {
-    return std::shared_ptr<class array>(
-      new (*m_memory_manager) simple_array(size, elements)
+    void* payload = nullptr;
+
+    if (!size && m_empty_array)
+    {
+      return m_empty_array;
+    }
+
+    return std::allocate_shared<simple_array>(
+      memory::allocator<simple_array>(
+        *m_memory_manager,
+        sizeof(array::value_type) * size,
+        &payload
+      ),
+      size,
+      elements,
+      &payload
     );
   }
 
@@ -912,6 +934,30 @@ namespace plorth
     }
   }
 
+  /**
+   * Word: >sequence
+   * Prototype: array
+   *
+   * Takes:
+   * - array
+   *
+   * Gives:
+   * - sequence
+   *
+   * Converts array into lazily evaluated sequence, so that it can be
+   * processed with map, filter and other sequence operations without
+   * constructing intermediate arrays.
+   */
+  static void w_to_sequence(const std::shared_ptr<context>& ctx)
+  {
+    std::shared_ptr<array> ary;
+
+    if (ctx->pop_array(ary))
+    {
+      ctx->push(ctx->runtime()->sequence(ary));
+    }
+  }
+
   /**
    * Word: for-each
    * Prototype: array
@@ -1155,6 +1201,301 @@ namespace plorth
     ctx->push(result);
   }
 
+  using parallel_callback = std::function<bool(
+    const std::shared_ptr<context>&,
+    array::size_type,
+    array::size_type,
+    std::size_t
+  )>;
+
+  /**
+   * Splits range of array indexes into chunks and processes them in worker
+   * threads. Each chunk is given an execution context of it's own, which
+   * shares the runtime and sees words from the local dictionary of the
+   * calling context, but has a separate data stack.
+   *
+   * \param ctx      Calling execution context, into which the error is
+   *                 transferred if processing of any chunk fails.
+   * \param size     Number of array elements to process.
+   * \param callback Callback which processes single chunk. It's given the
+   *                 execution context of the chunk, range of array indexes
+   *                 belonging to the chunk and index of the chunk.
+   * \param chunks   Where the number of chunks is placed into.
+   * \return         Boolean flag telling whether all chunks were processed
+   *                 successfully or not.
+   */
+  static bool parallel_chunks(const std::shared_ptr<context>& ctx,
+                              array::size_type size,
+                              const parallel_callback& callback,
+                              std::size_t& chunks)
+  {
+    const auto& runtime = ctx->runtime();
+    auto& memory_manager = runtime->memory_manager();
+    const std::shared_ptr<const class dictionary> dictionary(
+      ctx,
+      &ctx->dictionary()
+    );
+    const std::size_t grain = PLORTH_PARALLEL_GRAIN_SIZE;
+    std::vector<std::shared_ptr<class error>> errors;
+    std::size_t chunk_size;
+
+    // Use few chunks more than there are threads, so that the work is spread
+    // evenly between the threads even when some elements are slower to
+    // process than others.
+    chunks = std::min(
+      thread_pool::concurrency() * 4,
+      (size + grain - 1) / grain
+    );
+    if (chunks < 1)
+    {
+      chunks = 1;
+    }
+    chunk_size = (size + chunks - 1) / chunks;
+    if (chunk_size > 0)
+    {
+      chunks = (size + chunk_size - 1) / chunk_size;
+    }
+    errors.resize(chunks);
+
+    if (chunks > 1)
+    {
+      memory_manager.begin_concurrency();
+    }
+    thread_pool::run(chunks, [&](std::size_t chunk)
+    {
+      const auto begin = chunk * chunk_size;
+      const auto end = std::min(begin + chunk_size, size);
+      const auto worker = context::make(runtime, dictionary);
+
+      if (!callback(worker, begin, end, chunk))
+      {
+        errors[chunk] = worker->error();
+      }
+    });
+    if (chunks > 1)
+    {
+      memory_manager.end_concurrency();
+    }
+
+    for (const auto& error : errors)
+    {
+      if (error)
+      {
+        ctx->error(error);
+
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  /**
+   * Word: pmap
+   * Prototype: array
+   *
+   * Takes:
+   * - quote
+   * - array
+   *
+   * Gives:
+   * - array
+   *
+   * Parallel version of map. Large arrays are split into chunks which are
+   * processed simultaneously by multiple threads, each of which executes the
+   * quote with a data stack of it's own. The quote should not rely on side
+   * effects of other invocations; words defined by it are discarded.
+   */
+  static void w_pmap(const std::shared_ptr<context>& ctx)
+  {
+    std::shared_ptr<array> ary;
+    std::shared_ptr<quote> quo;
+    std::size_t chunks;
+
+    if (!ctx->pop_array(ary) || !ctx->pop_quote(quo))
+    {
+      return;
+    }
+
+    const auto size = ary->size();
+    std::vector<std::shared_ptr<value>> result(size);
+
+    if (parallel_chunks(
+      ctx,
+      size,
+      [&](const std::shared_ptr<context>& worker,
+          array::size_type begin,
+          array::size_type end,
+          std::size_t)
+      {
+        for (auto i = begin; i < end; ++i)
+        {
+          worker->push(ary->at(i));
+          if (!quo->call(worker) || !worker->pop(result[i]))
+          {
+            return false;
+          }
+        }
+
+        return true;
+      },
+      chunks
+    ))
+    {
+      ctx->push_array(result.data(), size);
+    }
+  }
+
+  /**
+   * Word: pfilter
+   * Prototype: array
+   *
+   * Takes:
+   * - quote
+   * - array
+   *
+   * Gives:
+   * - array
+   *
+   * Parallel version of filter. Large arrays are split into chunks which are
+   * tested simultaneously by multiple threads. Order of the elements is
+   * retained.
+   */
+  static void w_pfilter(const std::shared_ptr<context>& ctx)
+  {
+    std::shared_ptr<array> ary;
+    std::shared_ptr<quote> quo;
+    std::size_t chunks;
+
+    if (!ctx->pop_array(ary) || !ctx->pop_quote(quo))
+    {
+      return;
+    }
+
+    const auto size = ary->size();
+    std::vector<char> matches(size);
+    std::vector<std::shared_ptr<value>> result;
+
+    if (!parallel_chunks(
+      ctx,
+      size,
+      [&](const std::shared_ptr<context>& worker,
+          array::size_type begin,
+          array::size_type end,
+          std::size_t)
+      {
+        for (auto i = begin; i < end; ++i)
+        {
+          bool quote_result;
+
+          worker->push(ary->at(i));
+          if (!quo->call(worker) || !worker->pop_boolean(quote_result))
+          {
+            return false;
+          }
+          matches[i] = quote_result;
+        }
+
+        return true;
+      },
+      chunks
+    ))
+    {
+      return;
+    }
+
+    for (array::size_type i = 0; i < size; ++i)
+    {
+      if (matches[i])
+      {
+        result.push_back(ary->at(i));
+      }
+    }
+    ctx->push_array(result.data(), result.size());
+  }
+
+  /**
+   * Word: preduce
+   * Prototype: array
+   *
+   * Takes:
+   * - quote
+   * - array
+   *
+   * Gives:
+   * - any
+   *
+   * Parallel version of reduce. Large arrays are split into chunks which are
+   * reduced simultaneously by multiple threads, after which the results of
+   * the chunks are reduced into single value. The quote must therefore be
+   * associative, i.e. grouping of the elements must not affect the result.
+   */
+  static void w_preduce(const std::shared_ptr<context>& ctx)
+  {
+    std::shared_ptr<array> ary;
+    std::shared_ptr<quote> quo;
+    std::shared_ptr<value> result;
+    std::size_t chunks;
+
+    if (!ctx->pop_array(ary) || !ctx->pop_quote(quo))
+    {
+      return;
+    }
+
+    const auto size = ary->size();
+    std::vector<std::shared_ptr<value>> partials(
+      std::min(size, thread_pool::concurrency() * 4)
+    );
+
+    if (size == 0)
+    {
+      ctx->error(error::code::range, U"Cannot reduce empty array.");
+      return;
+    }
+
+    if (!parallel_chunks(
+      ctx,
+      size,
+      [&](const std::shared_ptr<context>& worker,
+          array::size_type begin,
+          array::size_type end,
+          std::size_t chunk)
+      {
+        auto& partial = partials[chunk];
+
+        partial = ary->at(begin);
+        for (auto i = begin + 1; i < end; ++i)
+        {
+          worker->push(partial);
+          worker->push(ary->at(i));
+          if (!quo->call(worker) || !worker->pop(partial))
+          {
+            return false;
+          }
+        }
+
+        return true;
+      },
+      chunks
+    ))
+    {
+      return;
+    }
+
+    result = partials[0];
+    for (std::size_t i = 1; i < chunks; ++i)
+    {
+      ctx->push(result);
+      ctx->push(partials[i]);
+      if (!quo->call(ctx) || !ctx->pop(result))
+      {
+        return;
+      }
+    }
+
+    ctx->push(result);
+  }
+
   /**
    * Word: +
    * Prototype: array
@@ -1362,31 +1703,28 @@ namespace plorth
    * indices count backwards from the end. If the given index is out of bounds,
    * arange error will be thrown.
    */
-  static void w_get(const std::shared_ptr<context>& ctx)
+  static void w_get(context& ctx, std::shared_ptr<value>* arguments)
   {
-    std::shared_ptr<array> ary;
-    std::shared_ptr<number> num;
+    const auto& ary = static_cast<const array&>(*arguments[0]);
+    const auto size = ary.size();
+    number::int_type index = static_cast<const number&>(
+      *arguments[1]
+    ).as_int();
 
-    if (ctx->pop_array(ary) && ctx->pop_number(num))
+    if (index < 0)
     {
-      const auto size = ary->size();
-      number::int_type index = num->as_int();
-
-      if (index < 0)
-      {
-        index += ary->size();
-      }
-
-      ctx->push(ary);
+      index += size;
+    }
 
-      if (!size || index < 0 || index >= static_cast<number::int_type>(size))
-      {
-        ctx->error(error::code::range, U"Array index out of bounds.");
-        return;
-      }
+    ctx.push(arguments[0]);
 
-      ctx->push(ary->at(index));
+    if (!size || index < 0 || index >= static_cast<number::int_type>(size))
+    {
+      ctx.error(error::code::range, U"Array index out of bounds.");
+      return;
     }
+
+    ctx.push(ary.at(index));
   }
 
   /**
@@ -1466,6 +1804,7 @@ namespace plorth
         { U"flatten", w_flatten },
         { U"nflatten", w_nflatten },
         { U">quote", w_to_quote },
+        { U">sequence", w_to_sequence },
 
         { U"for-each", w_for_each },
         { U"2for-each", w_2for_each },
@@ -1473,12 +1812,15 @@ namespace plorth
         { U"2map", w_2map },
         { U"filter", w_filter },
         { U"reduce", w_reduce },
+        { U"pmap", w_pmap },
+        { U"pfilter", w_pfilter },
+        { U"preduce", w_preduce },
 
         { U"+", w_concat },
         { U"*", w_repeat },
         { U"&", w_intersect },
         { U"|", w_union },
-        { U"@", w_get },
+        { U"@", { w_get, { value::type::array, value::type::number } } },
         { U"!", w_set }
       };
     }
@@ -43,69 +43,13 @@ namespace plorth
   const number::real_type number::real_min = DBL_MIN;
   const number::real_type number::real_max = DBL_MAX;
 
-  namespace
-  {
-    class int_number : public number
-    {
-    public:
-      explicit int_number(int_type val)
-        : m_value(val) {}
-
-      enum number_type number_type() const
-      {
-        return number_type::integer;
-      }
-
-      int_type as_int() const
-      {
-        return m_value;
-      }
-
-      real_type as_real() const
-      {
-        return static_cast<number::real_type>(m_value);
-      }
-
-    private:
-      const int_type m_value;
-    };
-
-    class real_number : public number
-    {
-    public:
-      explicit real_number(number::real_type val)
-        : m_value(val) {}
-
-      enum number_type number_type() const
-      {
-        return number_type::real;
-      }
-
-      int_type as_int() const
-      {
-        number::real_type value = m_value;
-
-        if (value > 0.0)
-        {
-          value = std::floor(value);
-        }
-        if (value < 0.0)
-        {
-          value = std::ceil(value);
-        }
-
-        return static_cast<int_type>(value);
-      }
+  number::number(int_type value)
+    : m_number_type(number_type::integer)
+    , m_int_value(value) {}
 
-      real_type as_real() const
-      {
-        return m_value;
-      }
-
-    private:
-      const real_type m_value;
-    };
-  }
+  number::number(real_type value)
+    : m_number_type(number_type::real)
+    , m_real_value(value) {}
 
   bool number::equals(const std::shared_ptr<class value>& that) const
   {
@@ -142,35 +86,40 @@ namespace plorth
   std::shared_ptr<number> runtime::number(number::int_type value)
   {
 #if PLORTH_ENABLE_INTEGER_CACHE
-    static const int offset = 128;
-
-    if (value >= -128 && value <= 127)
+    if (value >= PLORTH_INTEGER_CACHE_MIN && value <= PLORTH_INTEGER_CACHE_MAX)
     {
-      const int index = value + offset;
-      auto reference = m_integer_cache[index];
-
-      if (!reference)
-      {
-        reference = std::shared_ptr<class number>(
-          new (*m_memory_manager) int_number(value)
-        );
-        m_integer_cache[index] = reference;
-      }
-
-      return reference;
+      return (*m_integer_cache)[value - PLORTH_INTEGER_CACHE_MIN];
     }
 #endif
 
-    return std::shared_ptr<class number>(
-      new (*m_memory_manager) int_number(value)
-    );
+    return this->value<class number>(value);
   }
 
   std::shared_ptr<number> runtime::number(number::real_type value)
   {
-    return std::shared_ptr<class number>(
-      new (*m_memory_manager) real_number(value)
-    );
+    // Negative zero and NaNs with sign bit set are not shared, as they
+    // would be displayed differently.
+    if (!std::signbit(value))
+    {
+      if (value == 0.0)
+      {
+        return m_real_zero;
+      }
+      else if (value == 1.0)
+      {
+        return m_real_one;
+      }
+      else if (std::isnan(value))
+      {
+        return m_real_nan;
+      }
+      else if (std::isinf(value))
+      {
+        return m_real_infinity;
+      }
+    }
+
+    return this->value<class number>(value);
   }
 
   std::shared_ptr<class number> runtime::number(const std::u32string& value)
@@ -560,36 +509,222 @@ namespace plorth
     }
   }
 
+  void number_store(const std::shared_ptr<runtime>& runtime,
+                    std::shared_ptr<value>& slot,
+                    number::int_type result)
+  {
+    // Number which is not referenced from anywhere else can be updated in
+    // place, as nothing else can observe the change.
+    if (slot.use_count() == 1 && slot->type() == value::type::number)
+    {
+      auto num = static_cast<number*>(slot.get());
+
+      num->m_number_type = number::number_type::integer;
+      num->m_int_value = result;
+    } else {
+      slot = runtime->number(result);
+    }
+  }
+
+  void number_store(const std::shared_ptr<runtime>& runtime,
+                    std::shared_ptr<value>& slot,
+                    number::real_type result)
+  {
+    if (slot.use_count() == 1 && slot->type() == value::type::number)
+    {
+      auto num = static_cast<number*>(slot.get());
+
+      num->m_number_type = number::number_type::real;
+      num->m_real_value = result;
+    } else {
+      slot = runtime->number(result);
+    }
+  }
+
   template<class RealOperation, class IntOperation>
-  static void number_op(
-    const std::shared_ptr<context>& ctx,
+  static inline void number_op(
+    const std::shared_ptr<class runtime>& runtime,
+    std::shared_ptr<value>& slot,
+    const number& a,
+    const number& b,
     const RealOperation& real_op,
     const IntOperation& int_op
   )
   {
-    std::shared_ptr<number> a;
-    std::shared_ptr<number> b;
-    number::real_type result;
+    const number::real_type result = real_op(a.as_real(), b.as_real());
 
-    if (!ctx->pop_number(b) || !ctx->pop_number(a))
+    if (a.is(number::number_type::integer) &&
+        b.is(number::number_type::integer) &&
+        std::fabs(result) <= number::int_max)
     {
-      return;
+      // Repeat the operation with full integer precision
+      number_store(runtime, slot, int_op(a.as_int(), b.as_int()));
+    } else {
+      // Otherwise keep it real as it seems to be integer overflow or either
+      // of the arguments are real numbers.
+      number_store(runtime, slot, result);
     }
+  }
 
-    result = real_op(a->as_real(), b->as_real());
-
-    if (a->is(number::number_type::integer) &&
-        b->is(number::number_type::integer) &&
-        std::fabs(result) <= number::int_max)
+  template<class RealComparison, class IntComparison>
+  static inline bool number_compare(const number& a,
+                                    const number& b,
+                                    const RealComparison& real_cmp,
+                                    const IntComparison& int_cmp)
+  {
+    if (a.is(number::number_type::real) || b.is(number::number_type::real))
     {
-      // Repeat the operation with full integer precision
-      ctx->push_int(int_op(a->as_int(), b->as_int()));
-      return;
+      return real_cmp(a.as_real(), b.as_real());
+    }
+
+    return int_cmp(a.as_int(), b.as_int());
+  }
+
+  void number_add(const std::shared_ptr<runtime>& runtime,
+                  std::shared_ptr<value>& slot,
+                  const number& a,
+                  const number& b)
+  {
+    number_op(
+      runtime,
+      slot,
+      a,
+      b,
+      std::plus<number::real_type>(),
+      std::plus<number::int_type>()
+    );
+  }
+
+  void number_sub(const std::shared_ptr<runtime>& runtime,
+                  std::shared_ptr<value>& slot,
+                  const number& a,
+                  const number& b)
+  {
+    number_op(
+      runtime,
+      slot,
+      a,
+      b,
+      std::minus<number::real_type>(),
+      std::minus<number::int_type>()
+    );
+  }
+
+  void number_mul(const std::shared_ptr<runtime>& runtime,
+                  std::shared_ptr<value>& slot,
+                  const number& a,
+                  const number& b)
+  {
+    number_op(
+      runtime,
+      slot,
+      a,
+      b,
+      std::multiplies<number::real_type>(),
+      std::multiplies<number::int_type>()
+    );
+  }
+
+  void number_div(const std::shared_ptr<runtime>& runtime,
+                  std::shared_ptr<value>& slot,
+                  const number& a,
+                  const number& b)
+  {
+    number_store(runtime, slot, a.as_real() / b.as_real());
+  }
+
+  void number_mod(const std::shared_ptr<runtime>& runtime,
+                  std::shared_ptr<value>& slot,
+                  const number& a,
+                  const number& b)
+  {
+    const auto dividend = a.as_real();
+    const auto divider = b.as_real();
+    number::real_type result = std::fmod(dividend, divider);
+
+    if (std::signbit(dividend) != std::signbit(divider)) {
+       result += divider;
     }
+    number_store(runtime, slot, result);
+  }
+
+  bool number_lt(const number& a, const number& b)
+  {
+    return number_compare(
+      a,
+      b,
+      std::less<number::real_type>(),
+      std::less<number::int_type>()
+    );
+  }
+
+  bool number_gt(const number& a, const number& b)
+  {
+    return number_compare(
+      a,
+      b,
+      std::greater<number::real_type>(),
+      std::greater<number::int_type>()
+    );
+  }
+
+  bool number_lte(const number& a, const number& b)
+  {
+    return number_compare(
+      a,
+      b,
+      std::less_equal<number::real_type>(),
+      std::less_equal<number::int_type>()
+    );
+  }
+
+  bool number_gte(const number& a, const number& b)
+  {
+    return number_compare(
+      a,
+      b,
+      std::greater_equal<number::real_type>(),
+      std::greater_equal<number::int_type>()
+    );
+  }
 
-    // Otherwise keep it real as it seems to be integer overflow or either of
-    // the arguments are real numbers.
-    ctx->push_real(result);
+  /**
+   * Applies binary operation to the arguments of a typed word and pushes the
+   * result. Number of the first argument is reused for the result, when
+   * nothing else references it.
+   */
+  static inline void binary_op(
+    context& ctx,
+    std::shared_ptr<value>* arguments,
+    void (*operation)(const std::shared_ptr<class runtime>&,
+                      std::shared_ptr<value>&,
+                      const number&,
+                      const number&)
+  )
+  {
+    operation(
+      ctx.runtime(),
+      arguments[1],
+      static_cast<const number&>(*arguments[1]),
+      static_cast<const number&>(*arguments[0])
+    );
+    ctx.push(std::move(arguments[1]));
+  }
+
+  /**
+   * Applies comparison to the arguments of a typed word and pushes the
+   * result.
+   */
+  static inline void comparison_op(
+    context& ctx,
+    const std::shared_ptr<value>* arguments,
+    bool (*comparison)(const number&, const number&)
+  )
+  {
+    ctx.push_boolean(comparison(
+      static_cast<const number&>(*arguments[1]),
+      static_cast<const number&>(*arguments[0])
+    ));
   }
 
   /**
@@ -605,9 +740,9 @@ namespace plorth
    *
    * Performs addition on the two given numbers.
    */
-  static void w_add(const std::shared_ptr<context>& ctx)
+  static void w_add(context& ctx, std::shared_ptr<value>* arguments)
   {
-    number_op(ctx, std::plus<number::real_type>(), std::plus<number::int_type>());
+    binary_op(ctx, arguments, number_add);
   }
 
   /**
@@ -623,9 +758,9 @@ namespace plorth
    *
    * Subtracts the second number from the first and returns the result.
    */
-  static void w_sub(const std::shared_ptr<context>& ctx)
+  static void w_sub(context& ctx, std::shared_ptr<value>* arguments)
   {
-    number_op(ctx, std::minus<number::real_type>(), std::minus<number::int_type>());
+    binary_op(ctx, arguments, number_sub);
   }
 
   /**
@@ -641,9 +776,9 @@ namespace plorth
    *
    * Performs multiplication on the two given numbers.
    */
-  static void w_mul(const std::shared_ptr<context>& ctx)
+  static void w_mul(context& ctx, std::shared_ptr<value>* arguments)
   {
-    number_op(ctx, std::multiplies<number::real_type>(), std::multiplies<number::int_type>());
+    binary_op(ctx, arguments, number_mul);
   }
 
   /**
@@ -659,15 +794,9 @@ namespace plorth
    *
    * Divides the first number by the second and returns the result.
    */
-  static void w_div(const std::shared_ptr<context>& ctx)
+  static void w_div(context& ctx, std::shared_ptr<value>* arguments)
   {
-    std::shared_ptr<number> a;
-    std::shared_ptr<number> b;
-
-    if (ctx->pop_number(b) && ctx->pop_number(a))
-    {
-      ctx->push_real(a->as_real() / b->as_real());
-    }
+    binary_op(ctx, arguments, number_div);
   }
 
   /**
@@ -684,24 +813,9 @@ namespace plorth
    * Computes the modulo of the first number with respect to the second number
    * i.e. the remainder after floor division.
    */
-  static void w_mod(const std::shared_ptr<context>& ctx)
+  static void w_mod(context& ctx, std::shared_ptr<value>* arguments)
   {
-    std::shared_ptr<number> a;
-    std::shared_ptr<number> b;
-    number::real_type dividend;
-    number::real_type divider;
-    number::real_type result;
-
-    if (ctx->pop_number(b) && ctx->pop_number(a))
-    {
-      dividend = a->as_real();
-      divider = b->as_real();
-      result = std::fmod(dividend, divider);
-      if (std::signbit(dividend) != std::signbit(divider)) {
-         result += divider;
-      }
-      ctx->push_real(result);
-    }
+    binary_op(ctx, arguments, number_mod);
   }
 
   template<typename Operation >
@@ -854,20 +968,9 @@ namespace plorth
    *
    * Returns true if the first number is less than the second one.
    */
-  static void w_lt(const std::shared_ptr<context>& ctx)
+  static void w_lt(context& ctx, std::shared_ptr<value>* arguments)
   {
-    std::shared_ptr<number> a;
-    std::shared_ptr<number> b;
-
-    if (ctx->pop_number(b) && ctx->pop_number(a))
-    {
-      if (a->is(number::number_type::real) || b->is(number::number_type::real))
-      {
-        ctx->push_boolean(a->as_real() < b->as_real());
-      } else {
-        ctx->push_boolean(a->as_int() < b->as_int());
-      }
-    }
+    comparison_op(ctx, arguments, number_lt);
   }
 
   /**
@@ -883,20 +986,9 @@ namespace plorth
    *
    * Returns true if the first number is greater than the second one.
    */
-  static void w_gt(const std::shared_ptr<context>& ctx)
+  static void w_gt(context& ctx, std::shared_ptr<value>* arguments)
   {
-    std::shared_ptr<number> a;
-    std::shared_ptr<number> b;
-
-    if (ctx->pop_number(b) && ctx->pop_number(a))
-    {
-      if (a->is(number::number_type::real) || b->is(number::number_type::real))
-      {
-        ctx->push_boolean(a->as_real() > b->as_real());
-      } else {
-        ctx->push_boolean(a->as_int() > b->as_int());
-      }
-    }
+    comparison_op(ctx, arguments, number_gt);
   }
 
   /**
@@ -912,20 +1004,9 @@ namespace plorth
    *
    * Returns true if the first number is less than or equal to the second one.
    */
-  static void w_lte(const std::shared_ptr<context>& ctx)
+  static void w_lte(context& ctx, std::shared_ptr<value>* arguments)
   {
-    std::shared_ptr<number> a;
-    std::shared_ptr<number> b;
-
-    if (ctx->pop_number(b) && ctx->pop_number(a))
-    {
-      if (a->is(number::number_type::real) || b->is(number::number_type::real))
-      {
-        ctx->push_boolean(a->as_real() <= b->as_real());
-      } else {
-        ctx->push_boolean(a->as_int() <= b->as_int());
-      }
-    }
+    comparison_op(ctx, arguments, number_lte);
   }
 
   /**
@@ -942,20 +1023,9 @@ namespace plorth
    * Returns true if the first number is greater than or equal to the second
    * one.
    */
-  static void w_gte(const std::shared_ptr<context>& ctx)
+  static void w_gte(context& ctx, std::shared_ptr<value>* arguments)
   {
-    std::shared_ptr<number> a;
-    std::shared_ptr<number> b;
-
-    if (ctx->pop_number(b) && ctx->pop_number(a))
-    {
-      if (a->is(number::number_type::real) || b->is(number::number_type::real))
-      {
-        ctx->push_boolean(a->as_real() >= b->as_real());
-      } else {
-        ctx->push_boolean(a->as_int() >= b->as_int());
-      }
-    }
+    comparison_op(ctx, arguments, number_gte);
   }
 
   namespace api
@@ -978,11 +1048,11 @@ namespace plorth
         { U"clamp", w_clamp },
         { U"in-range?", w_is_in_range },
 
-        { U"+", w_add },
-        { U"-", w_sub },
-        { U"*", w_mul },
-        { U"/", w_div },
-        { U"%", w_mod },
+        { U"+", { w_add, { value::type::number, value::type::number } } },
+        { U"-", { w_sub, { value::type::number, value::type::number } } },
+        { U"*", { w_mul, { value::type::number, value::type::number } } },
+        { U"/", { w_div, { value::type::number, value::type::number } } },
+        { U"%", { w_mod, { value::type::number, value::type::number } } },
 
         { U"&", w_bit_and },
         { U"|", w_bit_or },
@@ -991,10 +1061,10 @@ namespace plorth
         { U">>", w_shift_right },
         { U"~", w_bit_not },
 
-        { U"<", w_lt },
-        { U">", w_gt },
-        { U"<=", w_lte },
-        { U">=", w_gte }
+        { U"<", { w_lt, { value::type::number, value::type::number } } },
+        { U">", { w_gt, { value::type::number, value::type::number } } },
+        { U"<=", { w_lte, { value::type::number, value::type::number } } },
+        { U">=", { w_gte, { value::type::number, value::type::number } } }
       };
     }
   }
@@ -210,7 +210,7 @@ namespace plorth
         std::vector<mapped_type> result;
 
         result.reserve(m_object->size());
-        for (const auto property : m_object->entries())
+        for (const auto& property : m_object->entries())
         {
           if (property.first == m_key)
           {
@@ -228,7 +228,7 @@ namespace plorth
         std::vector<value_type> result;
 
         result.reserve(m_object->size());
-        for (const auto property : m_object->entries())
+        for (const auto& property : m_object->entries())
         {
           if (property.first == m_key)
           {
@@ -393,7 +393,7 @@ namespace plorth
     std::u32string result;
     bool first = true;
 
-    for (const auto property : entries())
+    for (const auto& property : entries())
     {
       if (first)
       {
@@ -419,7 +419,7 @@ namespace plorth
     bool first = true;
 
     result += '{';
-    for (const auto property : entries())
+    for (const auto& property : entries())
     {
       if (first)
       {
@@ -447,12 +447,12 @@ namespace plorth
     const std::vector<object::value_type>& properties
   )
   {
-    return std::shared_ptr<class object>(
-      new (*m_memory_manager) simple_object(
-        std::begin(properties),
-        std::end(properties)
-      )
-    );
+    if (properties.empty() && m_empty_object)
+    {
+      return m_empty_object;
+    }
+
+    return value<simple_object>(std::begin(properties), std::end(properties));
   }
 
   /**
@@ -481,7 +481,7 @@ namespace plorth
     }
 
     result.reserve(obj->size());
-    for (const auto key : obj->keys())
+    for (const auto& key : obj->keys())
     {
       result.push_back(runtime->string(key));
     }
@@ -541,7 +541,7 @@ namespace plorth
       return;
     }
 
-    for (const auto property : obj->entries())
+    for (const auto& property : obj->entries())
     {
       std::shared_ptr<value> pair[2];
 
@@ -669,25 +669,18 @@ namespace plorth
    * object. If the object does not have such a property, range error will be
    * thrown. Notice that inherited properties are also included in the search.
    */
-  static void w_get(const std::shared_ptr<context>& ctx)
+  static void w_get(context& ctx, std::shared_ptr<value>* arguments)
   {
-    std::shared_ptr<object> obj;
-    std::shared_ptr<string> id;
+    const auto& obj = static_cast<const object&>(*arguments[0]);
+    const auto id = static_cast<const string&>(*arguments[1]).to_string();
+    std::shared_ptr<value> val;
 
-    if (ctx->pop_object(obj) && ctx->pop_string(id))
+    ctx.push(arguments[0]);
+    if (obj.property(ctx.runtime(), id, val))
     {
-      std::shared_ptr<value> val;
-
-      ctx->push(obj);
-      if (obj->property(ctx->runtime(), id->to_string(), val))
-      {
-        ctx->push(val);
-      } else {
-        ctx->error(
-          error::code::range,
-          U"No such property: `" + id->to_string() + U"'"
-        );
-      }
+      ctx.push(std::move(val));
+    } else {
+      ctx.error(error::code::range, U"No such property: `" + id + U"'");
     }
   }
 
@@ -787,7 +780,7 @@ namespace plorth
         std::end(entries)
       );
 
-      for (const auto property : a->entries())
+      for (const auto& property : a->entries())
       {
         properties[property.first] = property.second;
       }
@@ -810,7 +803,7 @@ namespace plorth
         { U"has?", w_has },
         { U"has-own?", w_has_own },
         { U"new", w_new },
-        { U"@", w_get },
+        { U"@", { w_get, { value::type::object, value::type::string } } },
         { U"!", w_set },
         { U"delete", w_delete },
         { U"+", w_concat }
@@ -25,8 +25,15 @@
  */
 #include <plorth/context.hpp>
 
+#include <cassert>
+
+#include "./peephole.hpp"
 #include "./utils.hpp"
 
+#if !defined(PLORTH_MAX_CALL_DEPTH)
+# define PLORTH_MAX_CALL_DEPTH 1024
+#endif
+
 namespace plorth
 {
   namespace
@@ -34,30 +41,32 @@ namespace plorth
     /**
      * Compiled quote consists from sequence of words parsed from source code.
      * When called, values are iterated and each value is being executed as part
-     * of a script.
+     * of a script. Commonly used sequences of words are executed as single
+     * superinstructions.
      */
     class compiled_quote : public quote
     {
     public:
-      explicit compiled_quote(const std::vector<std::shared_ptr<value>>& values)
-        : m_values(values) {}
+      explicit compiled_quote(class runtime* runtime,
+                              const std::vector<std::shared_ptr<value>>& values)
+        : m_values(values)
+        , m_instructions(peephole::optimize(runtime, values)) {}
 
       inline enum quote_type quote_type() const
       {
         return quote_type::compiled;
       }
 
-      bool call(const std::shared_ptr<context>& ctx) const
+      bool call(const std::shared_ptr<context>& ctx) const;
+
+      inline const std::vector<std::shared_ptr<value>>& values() const
       {
-        for (const auto& value : m_values)
-        {
-          if (!value::exec(ctx, value))
-          {
-            return false;
-          }
-        }
+        return m_values;
+      }
 
-        return true;
+      inline const std::vector<peephole::instruction>& instructions() const
+      {
+        return m_instructions;
       }
 
       std::u32string to_string() const
@@ -111,6 +120,7 @@ namespace plorth
 
     private:
       const std::vector<std::shared_ptr<value>> m_values;
+      const std::vector<peephole::instruction> m_instructions;
     };
 
     /**
@@ -120,8 +130,12 @@ namespace plorth
     class native_quote : public quote
     {
     public:
-      explicit native_quote(callback cb)
-        : m_callback(cb) {}
+      explicit native_quote(const callback& cb)
+        : m_signature(static_cast<function>(nullptr))
+        , m_callback(cb) {}
+
+      explicit native_quote(const struct signature& signature)
+        : m_signature(signature) {}
 
       inline enum quote_type quote_type() const
       {
@@ -130,9 +144,43 @@ namespace plorth
 
       bool call(const std::shared_ptr<context>& ctx) const
       {
-        m_callback(ctx);
+        invoke(ctx);
 
-        return !ctx->error();
+        // Perform calls requested by the native word, as this quote is not
+        // being executed from the return stack of the context.
+        while (!ctx->error())
+        {
+          const auto callee = ctx->take_tail_call();
+
+          if (!callee)
+          {
+            return true;
+          }
+          else if (!callee->call(ctx))
+          {
+            return false;
+          }
+        }
+
+        return false;
+      }
+
+      /**
+       * Invokes the native function without processing calls requested by
+       * it.
+       */
+      inline void invoke(const std::shared_ptr<context>& ctx) const
+      {
+        if (m_signature.typed)
+        {
+          invoke_typed(*ctx);
+        }
+        else if (m_signature.plain)
+        {
+          m_signature.plain(ctx);
+        } else {
+          m_callback(ctx);
+        }
       }
 
       std::u32string to_string() const
@@ -148,22 +196,234 @@ namespace plorth
       }
 
     private:
+      /**
+       * Pops arguments of typed function from the stack and calls the
+       * function with them. If the stack does not contain the arguments, the
+       * same error is raised as checked pops performed by the function itself
+       * would raise, leaving the stack in the same state as well.
+       */
+      void invoke_typed(context& ctx) const
+      {
+        auto& stack = ctx.data();
+        std::shared_ptr<value> arguments[max_arity];
+
+        for (std::size_t i = 0; i < m_signature.arity; ++i)
+        {
+          if (i < m_signature.type_count)
+          {
+            if (stack.empty() || !value::is(stack.back(),
+                                            m_signature.types[i]))
+            {
+              ctx.pop(m_signature.types[i]);
+              return;
+            }
+          }
+          else if (stack.empty())
+          {
+            ctx.pop();
+            return;
+          }
+          arguments[i] = std::move(stack.back());
+          stack.pop_back();
+        }
+        m_signature.typed(ctx, arguments);
+      }
+
+    private:
+      const struct signature m_signature;
       const callback m_callback;
     };
+
+    /**
+     * Keeps track of the number of nested calls which consume the native C++
+     * stack.
+     */
+    class depth_guard
+    {
+    public:
+      explicit depth_guard(const std::shared_ptr<context>& ctx)
+        : m_context(ctx)
+      {
+        ++m_context->depth();
+      }
+
+      ~depth_guard()
+      {
+        --m_context->depth();
+      }
+
+    private:
+      const std::shared_ptr<context>& m_context;
+    };
+
+    /**
+     * Executes compiled quote. Instead of recursing through the native C++
+     * stack, calls to other compiled quotes are performed by pushing them
+     * into the return stack of the context. When a quote is called as the
+     * last instruction of another quote, frame of the caller is replaced with
+     * the callee, so tail recursive words run in constant space.
+     */
+    bool compiled_quote::call(const std::shared_ptr<context>& ctx) const
+    {
+      auto& frames = ctx->frames();
+      const auto base = frames.size();
+
+      if (ctx->depth() >= PLORTH_MAX_CALL_DEPTH)
+      {
+        ctx->error(error::code::range, U"Maximum call depth exceeded.");
+
+        return false;
+      }
+
+      const depth_guard guard(ctx);
+
+      frames.push_back({ this, nullptr, 0 });
+      while (frames.size() > base)
+      {
+        const auto quote = static_cast<const compiled_quote*>(
+          frames.back().quote
+        );
+        const auto& instructions = quote->instructions();
+        const auto offset = frames.back().offset++;
+        std::shared_ptr<class quote> callee;
+
+        if (offset >= instructions.size())
+        {
+          frames.pop_back();
+          continue;
+        }
+
+        const auto& instruction = instructions[offset];
+        const auto& value = quote->values()[instruction.offset];
+        bool success;
+
+        // Superinstructions covering single word are executed only when
+        // applicable, as otherwise the word is executed normally below.
+        if (instruction.opcode != peephole::opcode::exec
+            && (instruction.length > 1
+                || peephole::is_applicable(ctx, instruction)))
+        {
+          success = peephole::execute(ctx, instruction, quote->values());
+        }
+        else if (value::is(value, value::type::symbol))
+        {
+          success = resolve_symbol(
+            ctx,
+            std::static_pointer_cast<symbol>(value),
+            callee
+          );
+        } else {
+          success = value::exec(ctx, value);
+        }
+
+        // Native words may request further calls to be made once they have
+        // returned, which are processed here until compiled quote is found.
+        while (success && callee)
+        {
+          if (callee->is(quote_type::compiled))
+          {
+            const auto reference = callee.get();
+
+            // Tail call; the caller has nothing left to execute so it can
+            // be replaced by the callee.
+            if (offset + 1 >= instructions.size())
+            {
+              frames.back() = { reference, std::move(callee), 0 };
+            } else {
+              frames.push_back({ reference, std::move(callee), 0 });
+            }
+            break;
+          }
+          else if (callee->is(quote_type::native))
+          {
+            static_cast<const class native_quote*>(
+              callee.get()
+            )->invoke(ctx);
+            success = !ctx->error();
+            callee = ctx->take_tail_call();
+          } else {
+            success = callee->call(ctx);
+            callee.reset();
+          }
+        }
+
+        if (!success)
+        {
+          ctx->take_tail_call();
+          frames.resize(base);
+
+          return false;
+        }
+      }
+
+      return true;
+    }
   }
 
   std::shared_ptr<quote> runtime::compiled_quote(const std::vector<std::shared_ptr<class value>>& values)
   {
-    return std::shared_ptr<quote>(
-      new (*m_memory_manager) class compiled_quote(values)
-    );
+    return value<class compiled_quote>(this, values);
   }
 
   std::shared_ptr<quote> runtime::native_quote(quote::callback callback)
   {
-    return std::shared_ptr<quote>(
-      new (*m_memory_manager) class native_quote(callback)
-    );
+    return value<class native_quote>(callback);
+  }
+
+  std::shared_ptr<quote> runtime::native_quote(quote::function function)
+  {
+    return value<class native_quote>(quote::signature(function));
+  }
+
+  std::shared_ptr<quote> runtime::native_quote(
+    const quote::signature& signature
+  )
+  {
+    return value<class native_quote>(signature);
+  }
+
+  quote::signature::signature(quote::function function)
+    : plain(function)
+    , typed(nullptr)
+    , arity(0)
+    , type_count(0) {}
+
+  quote::signature::signature(quote::typed_function function,
+                              std::size_t arity)
+    : plain(nullptr)
+    , typed(function)
+    , arity(arity)
+    , type_count(0)
+  {
+    assert(arity <= max_arity);
+  }
+
+  quote::signature::signature(quote::typed_function function,
+                              std::initializer_list<enum value::type> types)
+    : plain(nullptr)
+    , typed(function)
+    , arity(types.size())
+    , type_count(types.size())
+  {
+    std::size_t i = 0;
+
+    assert(arity <= max_arity);
+    for (const auto type : types)
+    {
+      this->types[i++] = type;
+    }
+  }
+
+  const std::vector<std::shared_ptr<value>>* compiled_quote_values(
+    const std::shared_ptr<quote>& quote
+  )
+  {
+    if (!quote || !quote->is(quote::quote_type::compiled))
+    {
+      return nullptr;
+    }
+
+    return &std::static_pointer_cast<class compiled_quote>(quote)->values();
   }
 
   std::u32string quote::to_source() const
@@ -186,7 +446,7 @@ namespace plorth
 
     if (ctx->pop_quote(q))
     {
-      q->call(ctx);
+      ctx->tail_call(q);
     }
   }
 
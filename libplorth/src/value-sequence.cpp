@@ -0,0 +1,588 @@
+/*
+ * Copyright (c) 2017-2018, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <plorth/context.hpp>
+
+#include "./utils.hpp"
+
+namespace plorth
+{
+  namespace
+  {
+    using iterator_result = sequence::iterator::result;
+
+    /**
+     * Iterator which produces elements of an array.
+     */
+    class array_iterator : public sequence::iterator
+    {
+    public:
+      explicit array_iterator(const std::shared_ptr<class array>& array)
+        : m_array(array)
+        , m_index(0) {}
+
+      result next(const std::shared_ptr<context>&,
+                  std::shared_ptr<value>& slot)
+      {
+        if (m_index >= m_array->size())
+        {
+          return result::end;
+        }
+        slot = m_array->at(m_index++);
+
+        return result::value;
+      }
+
+    private:
+      const std::shared_ptr<class array> m_array;
+      array::size_type m_index;
+    };
+
+    /**
+     * Sequence which produces elements of an array.
+     */
+    class array_sequence : public sequence
+    {
+    public:
+      explicit array_sequence(const std::shared_ptr<class array>& array)
+        : m_array(array) {}
+
+      std::unique_ptr<iterator> iterate() const
+      {
+        return std::unique_ptr<iterator>(new array_iterator(m_array));
+      }
+
+    private:
+      const std::shared_ptr<class array> m_array;
+    };
+
+    /**
+     * Iterator which produces numbers from a numeric range. The current
+     * number is incremented in place when nothing else refers to it, so
+     * iterating a range does not allocate a new number for each step.
+     */
+    class range_iterator : public sequence::iterator
+    {
+    public:
+      explicit range_iterator(const std::shared_ptr<number>& start,
+                              const std::shared_ptr<number>& end,
+                              const std::shared_ptr<number>& step)
+        : m_current(start)
+        , m_end(end)
+        , m_step(step)
+        , m_started(false) {}
+
+      result next(const std::shared_ptr<context>& ctx,
+                  std::shared_ptr<value>& slot)
+      {
+        if (m_started)
+        {
+          number_add(
+            ctx->runtime(),
+            m_current,
+            static_cast<const number&>(*m_current),
+            *m_step
+          );
+        } else {
+          m_started = true;
+        }
+        if (!number_lt(static_cast<const number&>(*m_current), *m_end))
+        {
+          return result::end;
+        }
+        slot = m_current;
+
+        return result::value;
+      }
+
+    private:
+      std::shared_ptr<value> m_current;
+      const std::shared_ptr<number> m_end;
+      const std::shared_ptr<number> m_step;
+      bool m_started;
+    };
+
+    /**
+     * Sequence which produces numbers from a numeric range.
+     */
+    class range_sequence : public sequence
+    {
+    public:
+      explicit range_sequence(const std::shared_ptr<number>& start,
+                              const std::shared_ptr<number>& end,
+                              const std::shared_ptr<number>& step)
+        : m_start(start)
+        , m_end(end)
+        , m_step(step) {}
+
+      std::unique_ptr<iterator> iterate() const
+      {
+        return std::unique_ptr<iterator>(
+          new range_iterator(m_start, m_end, m_step)
+        );
+      }
+
+    private:
+      const std::shared_ptr<number> m_start;
+      const std::shared_ptr<number> m_end;
+      const std::shared_ptr<number> m_step;
+    };
+
+    /**
+     * Iterator which applies a quote to each element produced by another
+     * iterator.
+     */
+    class map_iterator : public sequence::iterator
+    {
+    public:
+      explicit map_iterator(std::unique_ptr<iterator> source,
+                            const std::shared_ptr<class quote>& quote)
+        : m_source(std::move(source))
+        , m_quote(quote) {}
+
+      result next(const std::shared_ptr<context>& ctx,
+                  std::shared_ptr<value>& slot)
+      {
+        const auto source_result = m_source->next(ctx, slot);
+
+        if (source_result != result::value)
+        {
+          return source_result;
+        }
+        ctx->push(std::move(slot));
+        if (!m_quote->call(ctx) || !ctx->pop(slot))
+        {
+          return result::error;
+        }
+
+        return result::value;
+      }
+
+    private:
+      const std::unique_ptr<iterator> m_source;
+      const std::shared_ptr<class quote> m_quote;
+    };
+
+    /**
+     * Sequence which applies a quote to each element of another sequence.
+     */
+    class map_sequence : public sequence
+    {
+    public:
+      explicit map_sequence(const std::shared_ptr<sequence>& source,
+                            const std::shared_ptr<class quote>& quote)
+        : m_source(source)
+        , m_quote(quote) {}
+
+      std::unique_ptr<iterator> iterate() const
+      {
+        return std::unique_ptr<iterator>(
+          new map_iterator(m_source->iterate(), m_quote)
+        );
+      }
+
+    private:
+      const std::shared_ptr<sequence> m_source;
+      const std::shared_ptr<class quote> m_quote;
+    };
+
+    /**
+     * Iterator which skips elements produced by another iterator that do
+     * not satisfy a testing quote.
+     */
+    class filter_iterator : public sequence::iterator
+    {
+    public:
+      explicit filter_iterator(std::unique_ptr<iterator> source,
+                               const std::shared_ptr<class quote>& quote)
+        : m_source(std::move(source))
+        , m_quote(quote) {}
+
+      result next(const std::shared_ptr<context>& ctx,
+                  std::shared_ptr<value>& slot)
+      {
+        for (;;)
+        {
+          const auto source_result = m_source->next(ctx, slot);
+          bool quote_result;
+
+          if (source_result != result::value)
+          {
+            return source_result;
+          }
+          ctx->push(slot);
+          if (!m_quote->call(ctx) || !ctx->pop_boolean(quote_result))
+          {
+            return result::error;
+          }
+          else if (quote_result)
+          {
+            return result::value;
+          }
+        }
+      }
+
+    private:
+      const std::unique_ptr<iterator> m_source;
+      const std::shared_ptr<class quote> m_quote;
+    };
+
+    /**
+     * Sequence which contains only those elements of another sequence that
+     * satisfy a testing quote.
+     */
+    class filter_sequence : public sequence
+    {
+    public:
+      explicit filter_sequence(const std::shared_ptr<sequence>& source,
+                               const std::shared_ptr<class quote>& quote)
+        : m_source(source)
+        , m_quote(quote) {}
+
+      std::unique_ptr<iterator> iterate() const
+      {
+        return std::unique_ptr<iterator>(
+          new filter_iterator(m_source->iterate(), m_quote)
+        );
+      }
+
+    private:
+      const std::shared_ptr<sequence> m_source;
+      const std::shared_ptr<class quote> m_quote;
+    };
+
+    /**
+     * Iterator which stops after given number of elements have been
+     * produced by another iterator.
+     */
+    class take_iterator : public sequence::iterator
+    {
+    public:
+      explicit take_iterator(std::unique_ptr<iterator> source,
+                             number::int_type count)
+        : m_source(std::move(source))
+        , m_remaining(count) {}
+
+      result next(const std::shared_ptr<context>& ctx,
+                  std::shared_ptr<value>& slot)
+      {
+        if (m_remaining <= 0)
+        {
+          return result::end;
+        }
+        --m_remaining;
+
+        return m_source->next(ctx, slot);
+      }
+
+    private:
+      const std::unique_ptr<iterator> m_source;
+      number::int_type m_remaining;
+    };
+
+    /**
+     * Sequence which contains at most given number of elements from the
+     * beginning of another sequence.
+     */
+    class take_sequence : public sequence
+    {
+    public:
+      explicit take_sequence(const std::shared_ptr<sequence>& source,
+                             number::int_type count)
+        : m_source(source)
+        , m_count(count) {}
+
+      std::unique_ptr<iterator> iterate() const
+      {
+        return std::unique_ptr<iterator>(
+          new take_iterator(m_source->iterate(), m_count)
+        );
+      }
+
+    private:
+      const std::shared_ptr<sequence> m_source;
+      const number::int_type m_count;
+    };
+  }
+
+  bool sequence::equals(const std::shared_ptr<value>& that) const
+  {
+    // Comparing elements would require evaluating both of the sequences,
+    // which may have side effects.
+    return this == that.get();
+  }
+
+  std::u32string sequence::to_string() const
+  {
+    return U"sequence";
+  }
+
+  std::u32string sequence::to_source() const
+  {
+    return U"<" + to_string() + U">";
+  }
+
+  std::shared_ptr<class sequence> runtime::sequence(
+    const std::shared_ptr<class array>& array
+  )
+  {
+    return value<array_sequence>(array);
+  }
+
+  std::shared_ptr<class sequence> runtime::range(
+    const std::shared_ptr<class number>& start,
+    const std::shared_ptr<class number>& end
+  )
+  {
+    return value<range_sequence>(start, end, number(number::int_type(1)));
+  }
+
+  /**
+   * Word: map
+   * Prototype: sequence
+   *
+   * Takes:
+   * - quote
+   * - sequence
+   *
+   * Gives:
+   * - sequence
+   *
+   * Constructs a sequence which applies quote to each element of the
+   * sequence. The quote is not called until the resulting sequence is
+   * iterated.
+   */
+  static void w_map(const std::shared_ptr<context>& ctx)
+  {
+    std::shared_ptr<sequence> seq;
+    std::shared_ptr<quote> quo;
+
+    if (ctx->pop_sequence(seq) && ctx->pop_quote(quo))
+    {
+      ctx->push(ctx->runtime()->value<map_sequence>(seq, quo));
+    }
+  }
+
+  /**
+   * Word: filter
+   * Prototype: sequence
+   *
+   * Takes:
+   * - quote
+   * - sequence
+   *
+   * Gives:
+   * - sequence
+   *
+   * Constructs a sequence which contains only those elements of the sequence
+   * that satisfy the provided testing quote. The quote is not called until
+   * the resulting sequence is iterated.
+   */
+  static void w_filter(const std::shared_ptr<context>& ctx)
+  {
+    std::shared_ptr<sequence> seq;
+    std::shared_ptr<quote> quo;
+
+    if (ctx->pop_sequence(seq) && ctx->pop_quote(quo))
+    {
+      ctx->push(ctx->runtime()->value<filter_sequence>(seq, quo));
+    }
+  }
+
+  /**
+   * Word: take
+   * Prototype: sequence
+   *
+   * Takes:
+   * - number
+   * - sequence
+   *
+   * Gives:
+   * - sequence
+   *
+   * Constructs a sequence which contains at most given number of elements
+   * from the beginning of the sequence.
+   *
+   *     3 0 1000000 range take >array  #=> [0, 1, 2]
+   */
+  static void w_take(const std::shared_ptr<context>& ctx)
+  {
+    std::shared_ptr<sequence> seq;
+    std::shared_ptr<number> num;
+
+    if (ctx->pop_sequence(seq) && ctx->pop_number(num))
+    {
+      const number::int_type count = num->as_int();
+
+      if (count < 0)
+      {
+        ctx->error(error::code::range, U"Invalid take count.");
+        return;
+      }
+      ctx->push(ctx->runtime()->value<take_sequence>(seq, count));
+    }
+  }
+
+  /**
+   * Word: for-each
+   * Prototype: sequence
+   *
+   * Takes:
+   * - quote
+   * - sequence
+   *
+   * Runs quote once for every element in the sequence.
+   */
+  static void w_for_each(const std::shared_ptr<context>& ctx)
+  {
+    std::shared_ptr<sequence> seq;
+    std::shared_ptr<quote> quo;
+    std::unique_ptr<sequence::iterator> iterator;
+    std::shared_ptr<value> element;
+    iterator_result result;
+
+    if (!ctx->pop_sequence(seq) || !ctx->pop_quote(quo))
+    {
+      return;
+    }
+
+    iterator = seq->iterate();
+    while ((result = iterator->next(ctx, element)) == iterator_result::value)
+    {
+      ctx->push(std::move(element));
+      if (!quo->call(ctx))
+      {
+        return;
+      }
+    }
+  }
+
+  /**
+   * Word: reduce
+   * Prototype: sequence
+   *
+   * Takes:
+   * - quote
+   * - sequence
+   *
+   * Gives:
+   * - any
+   *
+   * Applies given quote against an accumulator and each element in the
+   * sequence to reduce it into a single value. Elements are evaluated one
+   * at a time, so the sequence is never stored in memory as a whole.
+   */
+  static void w_reduce(const std::shared_ptr<context>& ctx)
+  {
+    std::shared_ptr<sequence> seq;
+    std::shared_ptr<quote> quo;
+    std::unique_ptr<sequence::iterator> iterator;
+    std::shared_ptr<value> accumulator;
+    std::shared_ptr<value> element;
+    iterator_result result;
+
+    if (!ctx->pop_sequence(seq) || !ctx->pop_quote(quo))
+    {
+      return;
+    }
+
+    iterator = seq->iterate();
+    result = iterator->next(ctx, accumulator);
+    if (result == iterator_result::end)
+    {
+      ctx->error(error::code::range, U"Cannot reduce empty sequence.");
+      return;
+    }
+
+    while (result == iterator_result::value &&
+           (result = iterator->next(ctx, element)) == iterator_result::value)
+    {
+      ctx->push(std::move(accumulator));
+      ctx->push(std::move(element));
+      if (!quo->call(ctx) || !ctx->pop(accumulator))
+      {
+        return;
+      }
+    }
+
+    if (result == iterator_result::end)
+    {
+      ctx->push(std::move(accumulator));
+    }
+  }
+
+  /**
+   * Word: >array
+   * Prototype: sequence
+   *
+   * Takes:
+   * - sequence
+   *
+   * Gives:
+   * - array
+   *
+   * Evaluates the sequence and constructs array from its elements.
+   */
+  static void w_to_array(const std::shared_ptr<context>& ctx)
+  {
+    std::shared_ptr<sequence> seq;
+    std::unique_ptr<sequence::iterator> iterator;
+    std::shared_ptr<value> element;
+    std::vector<std::shared_ptr<value>> elements;
+    iterator_result result;
+
+    if (!ctx->pop_sequence(seq))
+    {
+      return;
+    }
+
+    iterator = seq->iterate();
+    while ((result = iterator->next(ctx, element)) == iterator_result::value)
+    {
+      elements.push_back(std::move(element));
+    }
+
+    if (result == iterator_result::end)
+    {
+      ctx->push_array(elements.data(), elements.size());
+    }
+  }
+
+  namespace api
+  {
+    runtime::prototype_definition sequence_prototype()
+    {
+      return
+      {
+        { U"map", w_map },
+        { U"filter", w_filter },
+        { U"take", w_take },
+        { U"for-each", w_for_each },
+        { U"reduce", w_reduce },
+        { U">array", w_to_array },
+      };
+    }
+  }
+}
@@ -26,6 +26,8 @@
 #include <plorth/context.hpp>
 #include <plorth/unicode.hpp>
 
+#include "./json.hpp"
+#include "./search.hpp"
 #include "./utils.hpp"
 
 #include <algorithm>
@@ -35,12 +37,18 @@ namespace plorth
 {
   namespace
   {
+    /**
+     * Implementation of string where the characters are stored inline after
+     * the string object itself, in the same memory slot.
+     */
     class simple_string : public string
     {
     public:
-      explicit simple_string(const char32_t* chars, size_type length)
+      explicit simple_string(const char32_t* chars,
+                             size_type length,
+                             void** payload)
         : m_length(length)
-        , m_chars(m_length > 0 ? new char32_t[m_length] : nullptr)
+        , m_chars(static_cast<char32_t*>(*payload))
       {
         if (m_length > 0)
         {
@@ -48,14 +56,6 @@ namespace plorth
         }
       }
 
-      ~simple_string()
-      {
-        if (m_length > 0)
-        {
-          delete[] m_chars;
-        }
-      }
-
       inline size_type length() const
       {
         return m_length;
@@ -66,6 +66,11 @@ namespace plorth
         return m_chars[offset];
       }
 
+      const_pointer data() const
+      {
+        return m_chars;
+      }
+
     private:
       const size_type m_length;
       char32_t* m_chars;
@@ -97,6 +102,27 @@ namespace plorth
         }
       }
 
+      void copy(pointer output, size_type offset, size_type count) const
+      {
+        const size_type left_length = m_left->length();
+
+        if (offset < left_length)
+        {
+          const auto left_count = std::min(count, left_length - offset);
+
+          m_left->copy(output, offset, left_count);
+          output += left_count;
+          count -= left_count;
+          offset = 0;
+        } else {
+          offset -= left_length;
+        }
+        if (count > 0)
+        {
+          m_right->copy(output, offset, count);
+        }
+      }
+
     private:
       const size_type m_length;
       const std::shared_ptr<string> m_left;
@@ -123,6 +149,18 @@ namespace plorth
         return m_original->at(m_offset + offset);
       }
 
+      const_pointer data() const
+      {
+        const auto chars = m_original->data();
+
+        return chars ? chars + m_offset : nullptr;
+      }
+
+      void copy(pointer output, size_type offset, size_type count) const
+      {
+        m_original->copy(output, m_offset + offset, count);
+      }
+
     private:
       const std::shared_ptr<string> m_original;
       const size_type m_offset;
@@ -148,6 +186,12 @@ namespace plorth
         return m_original->at(length() - offset - 1);
       }
 
+      void copy(pointer output, size_type offset, size_type count) const
+      {
+        m_original->copy(output, length() - offset - count, count);
+        std::reverse(output, output + count);
+      }
+
     private:
       const std::shared_ptr<string> m_original;
     };
@@ -178,15 +222,34 @@ namespace plorth
     return true;
   }
 
+  string::const_pointer string::data() const
+  {
+    return nullptr;
+  }
+
+  void string::copy(pointer output, size_type offset, size_type count) const
+  {
+    const auto chars = data();
+
+    if (chars)
+    {
+      std::copy(chars + offset, chars + offset + count, output);
+    } else {
+      for (size_type i = 0; i < count; ++i)
+      {
+        output[i] = at(offset + i);
+      }
+    }
+  }
+
   std::u32string string::to_string() const
   {
     const size_type len = length();
-    std::u32string result;
+    std::u32string result(len, 0);
 
-    result.reserve(len);
-    for (size_type i = 0; i < len; ++i)
+    if (len > 0)
     {
-      result.append(1, at(i));
+      copy(&result[0], 0, len);
     }
 
     return result;
@@ -253,8 +316,22 @@ namespace plorth
   std::shared_ptr<string> runtime::string(string::const_pointer chars,
                                           string::size_type length)
   {
-    return std::shared_ptr<class string>(
-      new (*m_memory_manager) simple_string(chars, length)
+    void* payload = nullptr;
+
+    if (!length && m_empty_string)
+    {
+      return m_empty_string;
+    }
+
+    return std::allocate_shared<simple_string>(
+      memory::allocator<simple_string>(
+        *m_memory_manager,
+        sizeof(char32_t) * length,
+        &payload
+      ),
+      chars,
+      length,
+      &payload
     );
   }
 
@@ -308,6 +385,47 @@ namespace plorth
     ctx->push_boolean(true);
   }
 
+  /**
+   * Returns pointer to the characters of given string, copying them into the
+   * buffer if they are not stored sequentially in memory.
+   */
+  static string::const_pointer str_chars(const std::shared_ptr<string>& str,
+                                         std::u32string& buffer)
+  {
+    const auto chars = str->data();
+
+    if (chars)
+    {
+      return chars;
+    }
+    buffer = str->to_string();
+
+    return buffer.data();
+  }
+
+  /**
+   * Tests whether non-empty substring occurs in the string at given offset.
+   */
+  static bool str_matches(const std::shared_ptr<string>& str,
+                          string::size_type offset,
+                          const std::shared_ptr<string>& substr)
+  {
+    const auto length = substr->length();
+    std::u32string buffer;
+    const auto subchars = str_chars(substr, buffer);
+    const auto chars = str->data();
+    std::u32string range;
+
+    if (chars)
+    {
+      return std::equal(subchars, subchars + length, chars + offset);
+    }
+    range.resize(length);
+    str->copy(&range[0], offset, length);
+
+    return std::equal(subchars, subchars + length, std::begin(range));
+  }
+
   /**
    * Word: includes?
    * Prototype: string
@@ -327,54 +445,21 @@ namespace plorth
   {
     std::shared_ptr<string> str;
     std::shared_ptr<string> substr;
+    std::u32string str_buffer;
+    std::u32string substr_buffer;
 
     if (!ctx->pop_string(str) || !ctx->pop_string(substr))
     {
       return;
     }
 
-    const auto str_length = str->length();
-    const auto substr_length = substr->length();
-
-    if (substr_length > str_length)
-    {
-      ctx->push(str);
-      ctx->push_boolean(false);
-      return;
-    }
-    else if (!substr_length)
-    {
-      ctx->push(str);
-      ctx->push_boolean(true);
-      return;
-    }
-
-    for (string::size_type i = 0; i < str_length; ++i)
-    {
-      bool found = true;
-
-      if (i + substr_length > str_length)
-      {
-        break;
-      }
-      for (string::size_type j = 0; j < substr_length; ++j)
-      {
-        if (str->at(i + j) != substr->at(j))
-        {
-          found = false;
-          break;
-        }
-      }
-      if (found)
-      {
-        ctx->push(str);
-        ctx->push_boolean(true);
-        return;
-      }
-    }
-
     ctx->push(str);
-    ctx->push_boolean(false);
+    ctx->push_boolean(search::find(
+      str_chars(str, str_buffer),
+      str->length(),
+      str_chars(substr, substr_buffer),
+      substr->length()
+    ) != search::npos);
   }
 
   /**
@@ -398,52 +483,29 @@ namespace plorth
   {
     std::shared_ptr<string> str;
     std::shared_ptr<string> substr;
+    std::u32string str_buffer;
+    std::u32string substr_buffer;
+    std::size_t index;
 
     if (!ctx->pop_string(str) || !ctx->pop_string(substr))
     {
       return;
     }
 
-    const auto str_length = str->length();
-    const auto substr_length = substr->length();
+    index = search::find(
+      str_chars(str, str_buffer),
+      str->length(),
+      str_chars(substr, substr_buffer),
+      substr->length()
+    );
 
     ctx->push(str);
-
-    if (substr_length > str_length)
+    if (index == search::npos)
     {
       ctx->push_null();
-      return;
-    }
-    else if (!substr_length)
-    {
-      ctx->push_int(0);
-      return;
-    }
-
-    for (string::size_type i = 0; i < str_length; ++i)
-    {
-      bool found = true;
-
-      if (i + substr_length > str_length)
-      {
-        break;
-      }
-      for (string::size_type j = 0; j < substr_length; ++j)
-      {
-        if (str->at(i + j) != substr->at(j))
-        {
-          found = false;
-          break;
-        }
-      }
-      if (found)
-      {
-        ctx->push_int(i);
-        return;
-      }
+    } else {
+      ctx->push_int(index);
     }
-
-    ctx->push_null();
   }
 
   /**
@@ -467,52 +529,29 @@ namespace plorth
   {
     std::shared_ptr<string> str;
     std::shared_ptr<string> substr;
+    std::u32string str_buffer;
+    std::u32string substr_buffer;
+    std::size_t index;
 
     if (!ctx->pop_string(str) || !ctx->pop_string(substr))
     {
       return;
     }
 
-    const auto str_length = str->length();
-    const auto substr_length = substr->length();
+    index = search::find_last(
+      str_chars(str, str_buffer),
+      str->length(),
+      str_chars(substr, substr_buffer),
+      substr->length()
+    );
 
     ctx->push(str);
-
-    if (substr_length > str_length)
+    if (index == search::npos)
     {
       ctx->push_null();
-      return;
-    }
-    else if (!substr_length)
-    {
-      ctx->push_int(str_length);
-      return;
-    }
-
-    for (auto i = str_length; i > 0; --i)
-    {
-      bool found = true;
-
-      if (str_length - i + 1 < substr_length)
-      {
-        continue;
-      }
-      for (string::size_type j = 0; j < substr_length; ++j)
-      {
-        if (str->at(i + j - 1) != substr->at(j))
-        {
-          found = false;
-          break;
-        }
-      }
-      if (found)
-      {
-        ctx->push_int(i - 1);
-        return;
-      }
+    } else {
+      ctx->push_int(index);
     }
-
-    ctx->push_null();
   }
 
   /**
@@ -543,31 +582,17 @@ namespace plorth
     const auto str_length = str->length();
     const auto substr_length = substr->length();
 
+    ctx->push(str);
     if (substr_length > str_length)
     {
-      ctx->push(str);
       ctx->push_boolean(false);
-      return;
     }
     else if (!substr_length)
     {
-      ctx->push(str);
       ctx->push_boolean(true);
-      return;
-    }
-
-    for (string::size_type i = 0; i < substr_length; ++i)
-    {
-      if (str->at(i) != substr->at(i))
-      {
-        ctx->push(str);
-        ctx->push_boolean(false);
-        return;
-      }
+    } else {
+      ctx->push_boolean(str_matches(str, 0, substr));
     }
-
-    ctx->push(str);
-    ctx->push_boolean(true);
   }
 
   /**
@@ -597,31 +622,21 @@ namespace plorth
     const auto str_length = str->length();
     const auto substr_length = substr->length();
 
+    ctx->push(str);
     if (substr_length > str_length)
     {
-      ctx->push(str);
       ctx->push_boolean(false);
-      return;
     }
     else if (!substr_length)
     {
-      ctx->push(str);
       ctx->push_boolean(true);
-      return;
-    }
-
-    for (string::size_type i = 0; i < substr_length; ++i)
-    {
-      if (str->at(str_length - substr_length + i) != substr->at(i))
-      {
-        ctx->push(str);
-        ctx->push_boolean(false);
-        return;
-      }
+    } else {
+      ctx->push_boolean(str_matches(
+        str,
+        str_length - substr_length,
+        substr
+      ));
     }
-
-    ctx->push(str);
-    ctx->push_boolean(true);
   }
 
   /**
@@ -873,20 +888,19 @@ namespace plorth
   }
 
   static void str_convert(const std::shared_ptr<context>& ctx,
-                          char32_t (*callback)(char32_t))
+                          void (*callback)(char32_t*, std::size_t))
   {
     std::shared_ptr<string> str;
 
     if (ctx->pop_string(str))
     {
-      const auto length = str->length();
-      char32_t result[length];
+      auto result = str->to_string();
 
-      for (string::size_type i = 0; i < length; ++i)
+      if (!result.empty())
       {
-        result[i] = callback(str->at(i));
+        callback(&result[0], result.length());
       }
-      ctx->push_string(result, length);
+      ctx->push_string(result);
     }
   }
 
@@ -924,13 +938,18 @@ namespace plorth
     str_convert(ctx, unicode_tolower);
   }
 
-  static inline char32_t unicode_swapcase(char32_t c)
+  static void unicode_swapcase(char32_t* chars, std::size_t length)
   {
-    if (unicode_islower(c))
+    for (std::size_t i = 0; i < length; ++i)
     {
-      return unicode_toupper(c);
-    } else {
-      return unicode_tolower(c);
+      const auto c = chars[i];
+
+      if (unicode_islower(c))
+      {
+        chars[i] = unicode_toupper(c);
+      } else {
+        chars[i] = unicode_tolower(c);
+      }
     }
   }
 
@@ -970,22 +989,14 @@ namespace plorth
 
     if (ctx->pop_string(str))
     {
-      const auto length = str->length();
-      char32_t output[length];
+      auto result = str->to_string();
 
-      for (string::size_type i = 0; i < length; ++i)
+      if (!result.empty())
       {
-        auto c = str->at(i);
-
-        if (i == 0)
-        {
-          c = unicode_toupper(c);
-        } else {
-          c = unicode_tolower(c);
-        }
-        output[i] = c;
+        result[0] = unicode_toupper(result[0]);
+        unicode_tolower(&result[1], result.length() - 1);
       }
-      ctx->push_string(output, length);
+      ctx->push_string(result);
     }
   }
 
@@ -1137,6 +1148,33 @@ namespace plorth
     }
   }
 
+  /**
+   * Word: json-parse
+   * Prototype: string
+   *
+   * Takes:
+   * - string
+   *
+   * Gives:
+   * - any
+   *
+   * Parses string as JSON document and converts it into corresponding value.
+   * JSON objects become objects, arrays become arrays and so on. Value error
+   * will be thrown if the string is not valid JSON, if it contains unpaired
+   * surrogate escape sequences or if it contains numbers too large to be
+   * represented.
+   */
+  static void w_json_parse(const std::shared_ptr<context>& ctx)
+  {
+    std::shared_ptr<string> str;
+    std::shared_ptr<value> result;
+
+    if (ctx->pop_string(str) && json::parse(ctx, str, result))
+    {
+      ctx->push(result);
+    }
+  }
+
   /**
    * Word: +
    * Prototype: string
@@ -1336,6 +1374,7 @@ namespace plorth
         // TODO: replace
         // TODO: normalize
         { U">number", w_to_number },
+        { U"json-parse", w_json_parse },
 
         { U"+", w_concat },
         { U"*", w_repeat },
@@ -27,10 +27,12 @@
 
 namespace plorth
 {
-  symbol::symbol(const std::u32string& id, const struct position* position)
+  symbol::symbol(const std::u32string& id,
+                 const struct position* position,
+                 std::size_t hash)
     : m_id(id)
     , m_position(position ? new struct position(*position) : nullptr)
-    , m_hash(0) {}
+    , m_hash(hash) {}
 
   symbol::~symbol()
   {
@@ -78,15 +80,38 @@ namespace plorth
   }
 
   std::shared_ptr<class symbol> runtime::symbol(const std::u32string& id,
-                                    const struct position* position)
+                                    const struct position* position,
+                                    std::size_t hash)
   {
 #if PLORTH_ENABLE_SYMBOL_CACHE
+    // Symbols cached by the base runtime are shared with this one. The base
+    // runtime is frozen, so it's symbol cache is not modified anymore.
+    if (m_base)
+    {
+      const auto base_entry = m_base->m_symbol_cache.find(id);
+
+      if (base_entry != std::end(m_base->m_symbol_cache))
+      {
+        return base_entry->second;
+      }
+    }
+
+# if PLORTH_ENABLE_THREADS
+    std::unique_lock<std::mutex> lock(m_mutex, std::defer_lock);
+
+    if (m_memory_manager->concurrent())
+    {
+      lock.lock();
+    }
+# endif
     const auto entry = m_symbol_cache.find(id);
 
     if (entry == std::end(m_symbol_cache))
     {
-      const auto reference = std::shared_ptr<class symbol>(
-        new (*m_memory_manager) class symbol(id)
+      const std::shared_ptr<class symbol> reference = value<class symbol>(
+        id,
+        nullptr,
+        hash
       );
 
       m_symbol_cache[id] = reference;
@@ -96,9 +121,7 @@ namespace plorth
 
     return entry->second;
 #else
-    return std::shared_ptr<class symbol>(
-      new (*m_memory_manager) class symbol(id, position)
-    );
+    return value<class symbol>(id, position, hash);
 #endif
   }
 
@@ -136,7 +136,7 @@ namespace plorth
 
     if (ctx->pop_word(wrd))
     {
-      wrd->quote()->call(ctx);
+      ctx->tail_call(wrd->quote());
     }
   }
 
@@ -65,6 +65,9 @@ namespace plorth
 
     case type::error:
       return U"error";
+
+    case type::sequence:
+      return U"sequence";
     }
 
     return U"unknown";
@@ -103,6 +106,9 @@ namespace plorth
     case type::error:
       return runtime->error_prototype();
 
+    case type::sequence:
+      return runtime->sequence_prototype();
+
     case type::object:
       {
         std::shared_ptr<value> slot;
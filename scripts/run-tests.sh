@@ -6,8 +6,4 @@ mkdir -p build
 cd build
 cmake ..
 make
-for file in ../tests/test-*.plorth
-do
-  echo $file
-  ./cli/plorth $file
-done
+ctest --output-on-failure
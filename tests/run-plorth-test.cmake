@@ -0,0 +1,32 @@
+# Runs a test script written in Plorth inside an empty working directory of
+# its own, which is removed afterwards. Compiled modules are cached inside the
+# working directory as well, instead of the cache directory of the user.
+# Expects following variables:
+#
+# - PLORTH_EXECUTABLE: Path to the Plorth interpreter.
+# - PLORTH_TEST: Path to the test script.
+# - PLORTH_WORK_DIRECTORY: Directory under which working directories are
+#   created.
+
+STRING(RANDOM LENGTH 16 SUFFIX)
+GET_FILENAME_COMPONENT(NAME ${PLORTH_TEST} NAME_WE)
+SET(DIRECTORY ${PLORTH_WORK_DIRECTORY}/${NAME}-${SUFFIX})
+
+FILE(MAKE_DIRECTORY ${DIRECTORY})
+SET(ENV{PLORTH_CACHE_DIR} ${DIRECTORY}/cache)
+
+EXECUTE_PROCESS(
+  COMMAND ${PLORTH_EXECUTABLE} ${PLORTH_TEST}
+  WORKING_DIRECTORY ${DIRECTORY}
+  RESULT_VARIABLE RESULT
+  OUTPUT_VARIABLE OUTPUT
+  ERROR_VARIABLE OUTPUT
+)
+
+FILE(REMOVE_RECURSE ${DIRECTORY})
+
+MESSAGE("${OUTPUT}")
+
+IF(NOT RESULT EQUAL 0 OR OUTPUT MATCHES "✘")
+  MESSAGE(FATAL_ERROR "Test ${NAME} failed.")
+ENDIF()
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2017-2018, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <plorth/compiler.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace plorth;
+
+/**
+ * Feeds given chunks of source code into an incremental compiler one by one
+ * and executes the values completed by each chunk.
+ */
+static bool run(const std::shared_ptr<context>& ctx,
+                incremental_compiler& compiler,
+                const std::vector<std::string>& chunks)
+{
+  std::shared_ptr<quote> script;
+
+  for (const auto& chunk : chunks)
+  {
+    if (!compiler.feed(ctx, chunk.c_str(), chunk.length(), script)
+        || (script && !script->call(ctx)))
+    {
+      return false;
+    }
+  }
+
+  return compiler.finish(ctx, script) && (!script || script->call(ctx));
+}
+
+/**
+ * Removes all values from the data stack of the context and returns their
+ * source code representations separated with spaces.
+ */
+static std::u32string drain(const std::shared_ptr<context>& ctx)
+{
+  std::u32string result;
+
+  for (const auto& value : ctx->data())
+  {
+    if (!result.empty())
+    {
+      result += U' ';
+    }
+    result += value ? value->to_source() : U"null";
+  }
+  ctx->clear();
+
+  return result;
+}
+
+static bool test(const std::shared_ptr<context>& ctx,
+                 const char* description,
+                 const std::vector<std::string>& chunks,
+                 const std::u32string& expected)
+{
+  incremental_compiler compiler;
+  std::u32string result;
+
+  if (!run(ctx, compiler, chunks))
+  {
+    std::cerr << description << ": Compilation failed." << std::endl;
+    ctx->clear_error();
+    ctx->clear();
+
+    return false;
+  }
+  if ((result = drain(ctx)) != expected)
+  {
+    std::cerr << description
+              << ": Expected `"
+              << utf8_encode(expected)
+              << "', got `"
+              << utf8_encode(result)
+              << "'."
+              << std::endl;
+
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Feeds source code containing a syntax error into an incremental compiler,
+ * resets it and checks that it can be used to compile more source code.
+ */
+static bool test_reset(const std::shared_ptr<context>& ctx)
+{
+  incremental_compiler compiler;
+  std::shared_ptr<quote> script;
+
+  if (!compiler.feed(ctx, "1\n2\n", 4, script) || !script->call(ctx))
+  {
+    std::cerr << "Compilation failed." << std::endl;
+
+    return false;
+  }
+  if (compiler.feed(ctx, "( 3 ]", 5, script) || !ctx->error())
+  {
+    std::cerr << "Syntax error was not detected." << std::endl;
+
+    return false;
+  }
+  if (!ctx->error()->position() || ctx->error()->position()->line != 3)
+  {
+    std::cerr << "Syntax error has wrong position." << std::endl;
+
+    return false;
+  }
+  ctx->clear_error();
+  ctx->clear();
+
+  if (!compiler.feed(ctx, "( 4", 3, script) || !compiler.pending())
+  {
+    std::cerr << "Incomplete quote was not detected." << std::endl;
+
+    return false;
+  }
+  compiler.reset();
+  if (compiler.pending())
+  {
+    std::cerr << "Incomplete quote was not discarded." << std::endl;
+
+    return false;
+  }
+
+  return test(ctx, "Reset", { "5 6", " +" }, U"11");
+}
+
+int main()
+{
+  memory::manager memory_manager;
+  auto runtime = runtime::make(memory_manager);
+  auto ctx = context::make(runtime);
+
+  if (!test(ctx, "Identifier", { "1 2 sw", "ap" }, U"2 1")
+      || !test(ctx, "Escape", { "\"a\\", "\"b\"" }, U"\"a\\\"b\"")
+      || !test(
+        ctx,
+        "Multibyte",
+        { "\"\xc3", "\xa9\" : \xc3", "\xa9 7 ; \xc3", "\xa9" },
+        U"\"é\" 7"
+      )
+      || !test(ctx, "Comment", { "1 # (", " [\n2" }, U"1 2")
+      || !test(ctx, "Word", { ": dou", "ble 2 ", "* ;", " 3 double" }, U"6")
+      || !test(
+        ctx,
+        "Nested",
+        { "[1, (", " 2 ) ", "] { \"a", "\": 3 }" },
+        U"[1, (2)] {\"a\": 3}"
+      )
+      || !test_reset(ctx))
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
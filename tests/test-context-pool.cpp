@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2017-2018, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <plorth/context-pool.hpp>
+
+#include <cstdlib>
+#include <iostream>
+
+using namespace plorth;
+
+static bool run(const std::shared_ptr<context>& ctx,
+                const std::u32string& source)
+{
+  auto script = ctx->compile(source);
+
+  return script && script->call(ctx);
+}
+
+static bool expect(bool condition, const char* message)
+{
+  if (!condition)
+  {
+    std::cerr << message << std::endl;
+  }
+
+  return condition;
+}
+
+/**
+ * Acquires a context from a pool, modifies it's state, releases it back into
+ * the pool and acquires it again. The context must have been reset back into
+ * it's initial state, while words of the template dictionary must still be
+ * available.
+ */
+static bool test_round_trip(const std::shared_ptr<runtime>& runtime,
+                            const dictionary& dictionary_template)
+{
+  context_pool pool(runtime, dictionary_template);
+  auto ctx = pool.acquire();
+  const auto original = ctx.get();
+  std::shared_ptr<quote> script;
+
+  // The same compiled script is executed again after the context has been
+  // reset, so that the result of the symbol lookup in the inline cache of the
+  // context would be reused unless the cache was invalidated.
+  if (!expect(run(ctx, U"answer drop : local 1 ;")
+              && (script = ctx->compile(U"local"))
+              && script->call(ctx),
+              "Unable to execute script.")
+      || !expect(!run(ctx, U"unknown"), "Reference error was not thrown."))
+  {
+    return false;
+  }
+
+  pool.release(ctx);
+  ctx.reset();
+  if (!expect(pool.size() == 1, "Context was not returned into the pool."))
+  {
+    return false;
+  }
+
+  ctx = pool.acquire();
+  if (!expect(ctx.get() == original, "Context was not reused.")
+      || !expect(pool.size() == 0, "Context was not taken from the pool.")
+      || !expect(ctx->empty(), "Data stack was not cleared.")
+      || !expect(!ctx->error(), "Error was not cleared.")
+      || !expect(!ctx->dictionary().find(U"local"),
+                 "Local words were not removed.")
+      || !expect(!script->call(ctx), "Inline cache was not invalidated."))
+  {
+    return false;
+  }
+  ctx->clear_error();
+  if (!expect(run(ctx, U"answer") && ctx->size() == 1,
+              "Words of the template dictionary were lost."))
+  {
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Releases more contexts into a pool than it can retain.
+ */
+static bool test_max_size(const std::shared_ptr<runtime>& runtime)
+{
+  context_pool pool(runtime, dictionary(), 2);
+  auto first = pool.acquire();
+  auto second = pool.acquire();
+  auto third = pool.acquire();
+
+  pool.release(first);
+  pool.release(second);
+  pool.release(third);
+  if (!expect(pool.size() == 2, "Pool retained too many contexts."))
+  {
+    return false;
+  }
+  pool.acquire();
+  pool.reserve(5);
+
+  return expect(pool.size() == 2, "Pool reserved too many contexts.");
+}
+
+int main()
+{
+  memory::manager memory_manager;
+  auto runtime = runtime::make(memory_manager);
+  auto scratch = context::make(runtime);
+
+  if (!run(scratch, U": answer 42 ;"))
+  {
+    std::cerr << "Unable to execute script." << std::endl;
+
+    return EXIT_FAILURE;
+  }
+
+  if (!test_round_trip(runtime, scratch->dictionary())
+      || !test_max_size(runtime))
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
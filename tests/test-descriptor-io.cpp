@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) 2017-2018, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <plorth/context.hpp>
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace plorth;
+
+static bool expect(bool condition, const char* message)
+{
+  if (!condition)
+  {
+    std::cerr << message << std::endl;
+  }
+
+  return condition;
+}
+
+/**
+ * Writes into a socket through file descriptor output, first while the peer
+ * is connected and then after the peer has closed it's end. Writing into
+ * the closed socket must not terminate the process with SIGPIPE.
+ */
+static bool test_output_socket(memory::manager& memory_manager)
+{
+  std::shared_ptr<io::output> output;
+  int fds[2];
+  char buffer[16];
+  ::ssize_t length;
+
+  if (!expect(!::socketpair(AF_UNIX, SOCK_STREAM, 0, fds),
+              "Unable to create socket pair."))
+  {
+    return false;
+  }
+
+  output = io::output::file_descriptor(memory_manager, fds[0]);
+  output->write(U"hello");
+  length = ::read(fds[1], buffer, sizeof(buffer));
+  if (!expect(length == 5 && std::string(buffer, 5) == "hello",
+              "Output was not written into the socket."))
+  {
+    return false;
+  }
+
+  ::close(fds[1]);
+  output->write(U"discarded");
+  output->write(U"discarded");
+  ::close(fds[0]);
+
+  return true;
+}
+
+/**
+ * Writes into a pipe which read end has been closed. This must not
+ * terminate the process with SIGPIPE either.
+ */
+static bool test_output_pipe(memory::manager& memory_manager)
+{
+  std::shared_ptr<io::output> output;
+  int fds[2];
+
+  if (!expect(!::pipe(fds), "Unable to create pipe."))
+  {
+    return false;
+  }
+
+  output = io::output::file_descriptor(memory_manager, fds[1]);
+  ::close(fds[0]);
+  output->write(U"discarded");
+  output->write(U"discarded");
+  ::close(fds[1]);
+
+  return true;
+}
+
+/**
+ * Reads from a datagram socket, so that every read from the file descriptor
+ * returns single datagram, with a multibyte sequence split between two
+ * datagrams.
+ */
+static bool test_input_split(memory::manager& memory_manager)
+{
+  static const char* datagrams[] = { "h", "\xc3", "\xa9", "!" };
+  std::shared_ptr<io::input> input;
+  std::u32string output;
+  io::input::size_type read;
+  int fds[2];
+
+  if (!expect(!::socketpair(AF_UNIX, SOCK_DGRAM, 0, fds),
+              "Unable to create socket pair."))
+  {
+    return false;
+  }
+  for (auto datagram : datagrams)
+  {
+    const auto length = std::strlen(datagram);
+
+    if (!expect(::send(fds[1], datagram, length, 0) == ::ssize_t(length),
+                "Unable to write into socket."))
+    {
+      return false;
+    }
+  }
+
+  input = io::input::file_descriptor(memory_manager, fds[0]);
+  if (!expect(input->read(3, output, read) == io::input::result::ok
+              && read == 3
+              && output == U"hé!",
+              "Multibyte sequence split between reads was not decoded."))
+  {
+    return false;
+  }
+  ::close(fds[0]);
+  ::close(fds[1]);
+
+  return true;
+}
+
+/**
+ * Reads from a pipe until end of input, first with complete input and then
+ * with input which ends in the middle of a multibyte sequence.
+ */
+static bool test_input_eof(memory::manager& memory_manager)
+{
+  std::shared_ptr<io::input> input;
+  std::u32string output;
+  io::input::size_type read;
+  int fds[2];
+
+  if (!expect(!::pipe(fds), "Unable to create pipe."))
+  {
+    return false;
+  }
+  if (!expect(::write(fds[1], "ab\xc3\xa9", 4) == 4,
+              "Unable to write into pipe."))
+  {
+    return false;
+  }
+  ::close(fds[1]);
+  input = io::input::file_descriptor(memory_manager, fds[0]);
+  if (!expect(input->read(0, output, read) == io::input::result::eof
+              && read == 3
+              && output == U"abé",
+              "Input was not read until end of input."))
+  {
+    return false;
+  }
+  ::close(fds[0]);
+
+  if (!expect(!::pipe(fds), "Unable to create pipe."))
+  {
+    return false;
+  }
+  if (!expect(::write(fds[1], "a\xc3", 2) == 2,
+              "Unable to write into pipe."))
+  {
+    return false;
+  }
+  ::close(fds[1]);
+  input = io::input::file_descriptor(memory_manager, fds[0]);
+  output.clear();
+  if (!expect(input->read(0, output, read) == io::input::result::failure,
+              "Truncated multibyte sequence was not detected."))
+  {
+    return false;
+  }
+  ::close(fds[0]);
+
+  return true;
+}
+
+/**
+ * Reads from a non-blocking pipe before any data has been written into it,
+ * so that the first read fails with EAGAIN. The input must wait until the
+ * data written by a child process arrives.
+ */
+static bool test_input_eagain(memory::manager& memory_manager)
+{
+  std::shared_ptr<io::input> input;
+  std::u32string output;
+  io::input::size_type read;
+  int fds[2];
+  ::pid_t pid;
+  int status;
+
+  if (!expect(!::pipe(fds), "Unable to create pipe."))
+  {
+    return false;
+  }
+  ::fcntl(fds[0], F_SETFL, ::fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+
+  if (!(pid = ::fork()))
+  {
+    ::close(fds[0]);
+    ::usleep(100000);
+    ::_exit(::write(fds[1], "x", 1) == 1 ? EXIT_SUCCESS : EXIT_FAILURE);
+  }
+  ::close(fds[1]);
+
+  input = io::input::file_descriptor(memory_manager, fds[0]);
+  if (!expect(input->read(1, output, read) == io::input::result::ok
+              && read == 1
+              && output == U"x",
+              "Input did not wait for data to arrive."))
+  {
+    return false;
+  }
+  ::waitpid(pid, &status, 0);
+  ::close(fds[0]);
+
+  return true;
+}
+
+int main()
+{
+  memory::manager memory_manager;
+
+  if (!test_output_socket(memory_manager)
+      || !test_output_pipe(memory_manager)
+      || !test_input_split(memory_manager)
+      || !test_input_eof(memory_manager)
+      || !test_input_eagain(memory_manager))
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
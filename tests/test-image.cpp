@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2017-2018, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <plorth/context.hpp>
+
+#include <cstdlib>
+#include <iostream>
+
+using namespace plorth;
+
+static bool run(const std::shared_ptr<context>& ctx,
+                const std::u32string& source)
+{
+  auto script = ctx->compile(source);
+
+  return script && script->call(ctx);
+}
+
+static bool pop_int(const std::shared_ptr<context>& ctx, number::int_type& slot)
+{
+  std::shared_ptr<number> value;
+
+  if (!ctx->pop_number(value))
+  {
+    return false;
+  }
+  slot = value->as_int();
+
+  return true;
+}
+
+/**
+ * Saves words and data stack of a context into an image and loads them back
+ * into another runtime. The image includes a word in the global dictionary
+ * which overrides a built-in word, which must not be mistaken for the
+ * built-in one.
+ */
+int main()
+{
+  memory::manager memory_manager;
+  auto runtime = runtime::make(memory_manager);
+  auto ctx = context::make(runtime);
+  auto scratch = context::make(runtime);
+  std::shared_ptr<context> loaded;
+  number::int_type result;
+  std::string image;
+
+  if (!run(scratch, U": dup 42 ;")
+      || !run(ctx, U": double 2 * ; 5 double"))
+  {
+    std::cerr << "Unable to execute script." << std::endl;
+
+    return EXIT_FAILURE;
+  }
+  runtime->dictionary().insert(scratch->dictionary().find(U"dup"));
+
+  if (!runtime->save_image(ctx, image))
+  {
+    std::cerr << "Unable to save image." << std::endl;
+
+    return EXIT_FAILURE;
+  }
+
+  runtime = runtime::make(memory_manager);
+  loaded = context::make(runtime);
+  if (!runtime->load_image(loaded, image.c_str(), image.length()))
+  {
+    std::cerr << "Unable to load image." << std::endl;
+
+    return EXIT_FAILURE;
+  }
+
+  if (loaded->size() != 1 || !pop_int(loaded, result) || result != 10)
+  {
+    std::cerr << "Data stack was not restored." << std::endl;
+
+    return EXIT_FAILURE;
+  }
+  if (!run(loaded, U"3 double") || !pop_int(loaded, result) || result != 6)
+  {
+    std::cerr << "Word of the context was not restored." << std::endl;
+
+    return EXIT_FAILURE;
+  }
+  if (!run(loaded, U"1 dup") || !pop_int(loaded, result) || result != 42)
+  {
+    std::cerr << "Word overriding built-in word was not restored." << std::endl;
+
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2017-2018, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <plorth/context.hpp>
+
+#include <cstdlib>
+#include <iostream>
+
+using namespace plorth;
+
+/**
+ * Allocates memory inside an allocation region and releases part of it
+ * before the region ends. Once the arena pool has been promoted into an
+ * ordinary memory pool, the released memory must be reused.
+ */
+static bool test_region_promotion()
+{
+#if PLORTH_ENABLE_MEMORY_POOL
+  memory::manager memory_manager;
+  void* first;
+  void* second;
+  void* third;
+  void* fourth;
+
+  memory_manager.begin_region();
+  first = memory_manager.allocate(32);
+  second = memory_manager.allocate(32);
+  third = memory_manager.allocate(32);
+  fourth = memory_manager.allocate(32);
+  memory_manager.deallocate(first);
+  memory_manager.deallocate(second);
+  memory_manager.deallocate(fourth);
+  memory_manager.end_region();
+
+  if (memory_manager.allocate(32 * 2 + sizeof(memory::slot)) != first)
+  {
+    std::cerr << "Adjacent released slots were not merged." << std::endl;
+
+    return false;
+  }
+  if (memory_manager.allocate(32) != fourth)
+  {
+    std::cerr << "Released slot was not reused." << std::endl;
+
+    return false;
+  }
+  memory_manager.deallocate(third);
+#endif
+
+  return true;
+}
+
+namespace
+{
+  /**
+   * Object which counts how many times it has been destroyed.
+   */
+  struct node
+  {
+    explicit node(int& destroyed)
+      : destroyed(destroyed) {}
+
+    ~node()
+    {
+      ++destroyed;
+    }
+
+    int& destroyed;
+    std::shared_ptr<node> next;
+  };
+}
+
+/**
+ * Constructs a reference cycle of objects with an allocator and destroys
+ * the memory manager while the cycle still exists. Both objects must be
+ * destroyed exactly once.
+ */
+static bool test_teardown()
+{
+#if PLORTH_ENABLE_MEMORY_POOL
+  int destroyed = 0;
+
+  {
+    memory::manager memory_manager;
+    auto first = std::allocate_shared<node>(
+      memory::allocator<node>(memory_manager),
+      destroyed
+    );
+    auto second = std::allocate_shared<node>(
+      memory::allocator<node>(memory_manager),
+      destroyed
+    );
+
+    first->next = second;
+    second->next = first;
+  }
+
+  if (destroyed != 2)
+  {
+    std::cerr << "Objects were destroyed " << destroyed << " times." << std::endl;
+
+    return false;
+  }
+#endif
+
+  return true;
+}
+
+int main()
+{
+  if (!test_region_promotion() || !test_teardown())
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -48,15 +48,21 @@ namespace plorth
  */
 static void plorth_execute(const std::wstring& source)
 {
-  std::shared_ptr<quote> script;
+  bool success;
 
   if (!plorth_context)
   {
     plorth_initialize();
   }
 
-  script = plorth_context->compile(utf32le_decode(source));
-  if (!script || !script->call(plorth_context))
+  {
+    memory::region region(plorth_context->runtime()->memory_manager());
+    const auto script = plorth_context->compile(utf32le_decode(source));
+
+    success = script && script->call(plorth_context);
+  }
+
+  if (!success)
   {
     const auto err = plorth_context->error();
     std::wstring message;